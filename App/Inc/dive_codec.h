@@ -0,0 +1,73 @@
+#ifndef DIVE_CODEC_H
+#define DIVE_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dive_log.h"
+
+// Échantillon de plongée
+typedef struct {
+    uint16_t time;          // Secondes depuis début
+    int16_t depth;          // Profondeur en cm
+    int16_t temperature;    // Température en 0.1°C
+    uint8_t gas_idx;
+    uint8_t deco_time;      // Minutes de déco
+    uint8_t cns;            // % CNS
+    uint16_t events;        // Flags d'événements
+} DiveSample;
+
+// Encodage sans perte des échantillons, par blocs autonomes d'une page flash.
+// Chaque bloc commence par un en-tête : marqueur, numéro de la plongée (16 bits
+// de poids faible), index du premier échantillon (24 bits) et cet échantillon
+// en clair. Suivent des enregistrements delta :
+//   étiquette (drapeaux ci-dessous)
+//   [écart de temps - 1, varint]        si DIVE_CODEC_TIME
+//   [delta profondeur, varint zigzag]   si DIVE_CODEC_DEPTH
+//   [delta température, varint zigzag]  si DIVE_CODEC_TEMP
+//   [gaz] [déco] [CNS] [événements, varint] si changés
+// Un enregistrement ne chevauche jamais deux blocs ; la fin du bloc reste à
+// l'état effacé (0xFF, bit DIVE_CODEC_END). Un bloc illisible n'empêche pas
+// de décoder les suivants ; un bloc d'une autre plongée (tampon circulaire
+// repassé dessus) est rejeté comme illisible.
+#define DIVE_CODEC_BLOCK_SIZE       DIVE_LOG_PAGE_SIZE
+#define DIVE_CODEC_BLOCK_MARKER     0xD5
+#define DIVE_CODEC_ID_SIZE          6       // Marqueur, plongée, index (DiveCodec_BlockIndex)
+#define DIVE_CODEC_HEADER_SIZE      17
+#define DIVE_CODEC_MAX_RECORD       17      // En-tête de bloc (enregistrement delta : 16 au plus)
+
+// Étiquette d'un enregistrement
+#define DIVE_CODEC_TIME             0x01    // Écart différent de 1 s
+#define DIVE_CODEC_DEPTH            0x02
+#define DIVE_CODEC_TEMP             0x04
+#define DIVE_CODEC_GAS              0x08
+#define DIVE_CODEC_DECO             0x10
+#define DIVE_CODEC_CNS              0x20
+#define DIVE_CODEC_EVENTS           0x40
+#define DIVE_CODEC_END              0x80    // Fin de bloc
+
+// État de l'encodeur d'une plongée
+typedef struct {
+    DiveSample last;            // Dernier échantillon encodé
+    uint16_t block_used;        // Octets du bloc courant (0 : aucun bloc)
+    uint32_t samples;           // Échantillons encodés
+    uint16_t dive;              // Numéro de plongée des en-têtes
+} DiveCodec;
+
+void DiveCodec_Init(DiveCodec* codec, uint32_t dive_number);
+
+// Encode un échantillon dans out (DIVE_CODEC_MAX_RECORD octets) ; renvoie la
+// taille. *new_block : le bloc courant est clos, à compléter jusqu'à la fin
+// de la page avant d'ajouter out (qui commence le bloc suivant).
+uint16_t DiveCodec_Encode(DiveCodec* codec, const DiveSample* sample, uint8_t* out, bool* new_block);
+
+// Index du premier échantillon d'un bloc (faux : pas d'en-tête valide, ou
+// bloc d'une autre plongée). Seuls les DIVE_CODEC_ID_SIZE premiers octets sont lus.
+bool DiveCodec_BlockIndex(const uint8_t* block, uint32_t dive_number, uint32_t* first_index);
+
+// Décode un bloc de la plongée dive_number : les échantillons [skip, skip + max)
+// du bloc sont copiés dans samples ; renvoie le nombre copié. *block_samples :
+// échantillons du bloc.
+uint16_t DiveCodec_DecodeBlock(const uint8_t* block, uint32_t dive_number, uint16_t skip,
+                               DiveSample* samples, uint16_t max, uint16_t* block_samples);
+
+#endif
\ No newline at end of file
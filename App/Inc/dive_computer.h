@@ -8,11 +8,26 @@
 #include "hardware_hal.h"
 #include "dive_manager.h"
 #include "ccr_manager.h"
+#include "ui_state.h"
 
 // Version du firmware
 #define FIRMWARE_VERSION "1.0.0"
 #define HARDWARE_VERSION "STM32-DC-v1"
 
+// Mise à jour des tissus en palier stable (intégration linéaire exacte)
+#define TISSUE_STEADY_MAX_INTERVAL_S 5     // Intervalle max entre deux mises à jour
+#define TISSUE_STEADY_DELTA_BAR      0.03  // Variation de pression forçant la mise à jour (~0.3 m)
+
+// Planificateur de remontée en tâche de fond
+#define PLANNER_SLICE_BUDGET_US      500   // Durée max d'une tranche de calcul
+#define BAILOUT_REFRESH_S            10    // Rafraîchissement du plan bailout en CCR
+
+// Intervalle de surface : tissus avancés d'un bloc depuis l'heure RTC
+#define SURFACE_UPDATE_INTERVAL_S    60    // Période des avances en surface (éveillé)
+
+// Veille profonde en surface (réveils RTC périodiques, voir HAL_EnterDeepSleepMode)
+#define DEEP_SLEEP_IDLE_S            120   // Inactivité (ni plongée ni bouton) avant la veille
+
 // Modes de fonctionnement
 typedef enum {
     MODE_SURFACE,
@@ -31,10 +46,34 @@ typedef struct {
     ZHL16Model zhl16;
     DiveManager dive;
     CCRManager ccr;
+    UIState ui;
     HardwareStatus hw;
     SystemConfig config;
     bool in_dive;
     bool emergency_mode;
+    
+    // Échéances de la boucle principale (ms SysTick) et seconde des tâches 1 Hz
+    uint32_t last_update_ms;
+    uint32_t last_100ms;
+    uint32_t last_1s;
+    uint32_t last_second;
+    
+    // Mise à jour différée des tissus
+    uint8_t tissue_pending_s;       // Secondes non encore intégrées
+    
+    // Plan de remontée et scénarios what-if en cours de calcul
+    // (les derniers plans complets restent publiés)
+    ZHL16ScenarioJob planner;
+    
+    // Plan bailout circuit ouvert tenu à jour en CCR (basse priorité)
+    ZHL16PlannerJob bailout_planner;
+    uint8_t bailout_age_s;          // Secondes depuis le dernier lancement
+    
+    // Heure RTC de la dernière avance des tissus en surface (0 : en plongée)
+    uint32_t surface_rtc;
+    
+    // SysTick (ms) de la dernière activité : bouton ou seconde de plongée
+    uint32_t activity_ms;
 } DiveComputer;
 
 // Fonctions principales
@@ -42,6 +81,10 @@ void DiveComputer_Init(DiveComputer* dc);
 void DiveComputer_Update(DiveComputer* dc);
 void DiveComputer_1HzTasks(DiveComputer* dc);
 void DiveComputer_10HzTasks(DiveComputer* dc);
+void DiveComputer_BackgroundTasks(DiveComputer* dc);
+void DiveComputer_RunOnce(DiveComputer* dc);
+bool DiveComputer_CanDeepSleep(const DiveComputer* dc);
+void DiveComputer_Wake(DiveComputer* dc);
 void DiveComputer_HandleButton(DiveComputer* dc, ButtonEvent event);
 void DiveComputer_SwitchMode(DiveComputer* dc, DiveMode new_mode);
 
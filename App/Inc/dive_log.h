@@ -0,0 +1,59 @@
+#ifndef DIVE_LOG_H
+#define DIVE_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Flash SPI W25Q64 : 8 Mo, secteurs de 4 Ko (effacement), pages de 256 octets (écriture)
+#define DIVE_LOG_PAGE_SIZE              256
+#define DIVE_LOG_SECTOR_SIZE            4096
+#define DIVE_LOG_FLASH_SECTORS          2048
+
+// Zone des échantillons : tampon circulaire de pages, les plus anciennes
+// plongées sont écrasées. Les secteurs qui précèdent sont réservés au journal.
+#define DIVE_LOG_SAMPLES_FIRST_SECTOR   256
+#define DIVE_LOG_SAMPLES_BASE           (DIVE_LOG_SAMPLES_FIRST_SECTOR * DIVE_LOG_SECTOR_SIZE)
+#define DIVE_LOG_SAMPLES_END            (DIVE_LOG_FLASH_SECTORS * DIVE_LOG_SECTOR_SIZE)
+#define DIVE_LOG_SAMPLES_SIZE           (DIVE_LOG_SAMPLES_END - DIVE_LOG_SAMPLES_BASE)
+
+// Enregistreur en flux d'une plongée : les octets s'accumulent dans une page
+// RAM ; pleine, elle passe en attente et l'autre page prend le relais. La page
+// en attente est écrite depuis la boucle de fond (DiveLog_Service), le secteur
+// étant effacé à la première page qui y entre : effacement lancé sans attendre,
+// la page reste en attente jusqu'à ce que la flash ne soit plus occupée. Si les
+// deux pages sont pleines, l'ajout écrit la page en attente lui-même (en
+// attendant l'effacement) plutôt que de perdre des octets.
+typedef struct {
+    uint8_t page[2][DIVE_LOG_PAGE_SIZE];
+    uint16_t fill;              // Octets dans la page active
+    uint8_t active;             // Page en cours de remplissage
+    bool pending;               // L'autre page attend son écriture
+    bool erasing;               // Effacement du secteur de write_address lancé
+    
+    uint32_t start;             // Adresse flash du début de la plongée
+    uint32_t write_address;     // Prochaine page à écrire (alignée)
+    uint32_t bytes;             // Octets acceptés depuis DiveLog_Begin
+    bool recording;
+    bool flash_error;
+} DiveLog;
+
+// Enregistreur positionné sur une adresse de la zone (alignée sur une page)
+void DiveLog_Init(DiveLog* log, uint32_t write_address);
+
+// Plongée : début à la page courante, ajout d'octets, fin (page partielle écrite)
+void DiveLog_Begin(DiveLog* log);
+bool DiveLog_Append(DiveLog* log, const void* data, uint16_t size);
+void DiveLog_Service(DiveLog* log);
+void DiveLog_Finish(DiveLog* log);
+
+// Complète la page active à l'état effacé : l'ajout suivant commence une page
+void DiveLog_PadPage(DiveLog* log);
+
+// Lecture d'un flux terminé à partir de son adresse de début (retour au début
+// de la zone compris)
+bool DiveLog_Read(uint32_t start, uint32_t offset, void* data, uint32_t size);
+
+// Adresse ramenée dans la zone des échantillons
+uint32_t DiveLog_Wrap(uint32_t address);
+
+#endif
\ No newline at end of file
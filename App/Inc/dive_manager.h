@@ -4,11 +4,16 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "zhl16_core.h"
+#include "dive_log.h"
+#include "dive_codec.h"
+#include "dive_store.h"
 
 #define DIVE_START_DEPTH 1.2        // Mètres
 #define DIVE_END_DEPTH 0.8          // Mètres
 #define DIVE_END_TIME 300           // 5 minutes
-#define MAX_DIVE_SAMPLES 3600       // 1 heure à 1Hz
+#define DIVE_START_TIME 20          // Secondes sous DIVE_START_DEPTH
+#define SAFETY_STOP_TIME 180        // Secondes (3 minutes)
+#define LOG_DEPTH_TOLERANCE 0.10    // Mètres (simplification du profil enregistré)
 #define DIVE_LOG_MAX_ENTRIES 100
 
 // Phase de plongée
@@ -22,23 +27,33 @@ typedef enum {
     PHASE_SURFACE_INTERVAL
 } DivePhase;
 
-// Échantillon de plongée
+// Événements d'un échantillon (DiveSample.events)
+#define DIVE_EVENT_GAS_SWITCH       0x0001
+#define DIVE_EVENT_ASCENT_RATE      0x0002
+#define DIVE_EVENT_CEILING          0x0004
+#define DIVE_EVENT_PPO2             0x0008
+
+// Simplification en ligne du profil (porte pivotante) : un échantillon reçu
+// est retenu tant que la droite depuis le dernier écrit jusqu'à lui passe à
+// ±tolérance de tous ceux reçus entre les deux ; sinon le précédent est écrit
+// et devient l'origine. Changement de gaz ou d'événements : écrit d'office.
 typedef struct {
-    uint16_t time;          // Secondes depuis début
-    int16_t depth;          // Profondeur en cm
-    int16_t temperature;    // Température en 0.1°C
-    uint8_t gas_idx;
-    uint8_t deco_time;      // Minutes de déco
-    uint8_t cns;            // % CNS
-    uint16_t events;        // Flags d'événements
-} DiveSample;
+    DiveSample anchor;          // Dernier échantillon écrit
+    DiveSample held;            // Dernier échantillon reçu, pas encore écrit
+    bool has_anchor;
+    bool has_held;
+    float slope_max;            // Pentes admissibles depuis l'ancre (cm/s)
+    float slope_min;
+} DiveSimplifier;
 
 // Profil de plongée
 typedef struct {
     // Identification
     uint32_t dive_number;
-    uint32_t start_timestamp;
+    uint32_t start_timestamp;   // Secondes de SysTick (base des échantillons)
     uint32_t end_timestamp;
+    uint32_t start_rtc;         // Heure RTC (Unix) du début et de la fin
+    uint32_t end_rtc;
     
     // Statistiques
     float max_depth;
@@ -58,9 +73,10 @@ typedef struct {
     uint8_t gases_used;
     float sac_rate;         // Surface Air Consumption
     
-    // Échantillons
-    DiveSample samples[MAX_DIVE_SAMPLES];
-    uint16_t num_samples;
+    // Échantillons (flux encodé en flash SPI, voir dive_codec.h)
+    uint32_t samples_address;
+    uint32_t samples_bytes;
+    uint32_t num_samples;
 } DiveProfile;
 
 // Gestionnaire de plongée
@@ -74,12 +90,22 @@ typedef struct {
     // Profil en cours
     DiveProfile current_dive;
     uint16_t sample_counter;
+    DiveLog log;                // Enregistreur des échantillons
+    DiveCodec codec;
+    DiveSimplifier simplifier;
+    DiveStore store;            // Journal des plongées (monté à l'init)
     
     // Statistiques temps réel
     float ascent_rate;          // m/min
     float descent_rate;         // m/min
     float avg_depth_sum;
     uint32_t avg_depth_samples;
+    float rate_last_depth;      // Dernière mesure des taux
+    uint32_t rate_last_time;    // 0 : aucune mesure
+    
+    // Détection début/fin (0 : condition non remplie)
+    uint32_t start_detect_time;
+    uint32_t end_detect_time;
     
     // Violations et alarmes
     bool ascent_rate_alarm;
@@ -101,6 +127,8 @@ typedef struct {
     float fast_ascent_rate;     // m/min pour alarme
     bool auto_start_dive;
     bool safety_stop_enforce;
+    uint16_t safety_stop_time;  // Secondes
+    float log_depth_tolerance;  // Mètres, 0 : tous les échantillons écrits
 } DiveManager;
 
 // Fonctions principales
@@ -112,8 +140,11 @@ bool DiveManager_CheckDiveStart(DiveManager* dm, float depth);
 bool DiveManager_CheckDiveEnd(DiveManager* dm, float depth);
 
 // Échantillonnage
-void DiveManager_RecordSample(DiveManager* dm, float depth, float temp, uint8_t gas, uint8_t deco);
-void DiveManager_CompressSamples(DiveManager* dm);
+void DiveManager_RecordSample(DiveManager* dm, float depth, float temp, uint8_t gas, uint8_t deco,
+                              float cns);
+void DiveManager_FlushSamples(DiveManager* dm);
+uint16_t DiveManager_ReadSamples(const DiveProfile* profile, uint32_t first, DiveSample* samples,
+                                 uint16_t count);
 
 // Taux de remontée/descente
 void DiveManager_UpdateRates(DiveManager* dm, float depth);
@@ -127,9 +158,11 @@ void DiveManager_ResetSafetyStop(DiveManager* dm);
 
 // Journal de plongée
 bool DiveManager_SaveDive(DiveManager* dm);
-bool DiveManager_LoadDive(uint32_t dive_number, DiveProfile* profile);
-uint32_t DiveManager_GetLastDiveNumber(void);
-void DiveManager_GetDiveList(uint32_t* dive_numbers, uint8_t max_count);
+bool DiveManager_LoadDive(DiveManager* dm, uint32_t dive_number, DiveProfile* profile);
+uint32_t DiveManager_GetLastDiveNumber(DiveManager* dm);
+void DiveManager_GetDiveList(DiveManager* dm, uint32_t* dive_numbers, uint8_t max_count);
+uint16_t DiveManager_GetLogbookPage(DiveManager* dm, uint32_t first, DiveSummary* entries, uint16_t count);
+uint32_t DiveManager_GetLogbookSize(DiveManager* dm);
 
 // Statistiques
 float DiveManager_CalculateSAC(DiveManager* dm, float start_pressure, float end_pressure);
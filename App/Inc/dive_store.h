@@ -0,0 +1,107 @@
+#ifndef DIVE_STORE_H
+#define DIVE_STORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "dive_log.h"
+
+// Journal des plongées : profils (DiveProfile, vus ici comme des octets
+// opaques) ajoutés à la suite dans les premiers secteurs de la flash SPI,
+// jamais réécrits en place.
+//
+// Chaque secteur est découpé en emplacements de 128 octets : le premier porte
+// l'en-tête du secteur (séquence d'ouverture, nombre d'effacements, numéro de
+// la première plongée), les suivants un enregistrement chacun (en-tête avec
+// CRC-32, puis le profil). Un secteur plein fait ouvrir le suivant dans
+// l'anneau : effacé, il perd ses plus anciennes plongées et tous les secteurs
+// s'usent au même rythme.
+//
+// L'index en RAM tient l'en-tête de chaque secteur : le montage lit ces en-têtes
+// puis les emplacements du seul secteur actif. Une coupure d'alimentation
+// laisse au pire un enregistrement ou un en-tête au CRC faux, ignoré.
+//
+// Table des résumés : secteurs suivant le journal, entrées de 32 octets (8 par
+// page) écrites après chaque enregistrement, à la position de son rang dans le
+// journal modulo la taille de la table. Le carnet parcourt les plongées par
+// pages d'entrées contiguës, une lecture flash par page, sans lire les profils.
+#define DIVE_STORE_FIRST_SECTOR     0
+#define DIVE_STORE_SECTORS          64
+#define DIVE_STORE_SLOT_SIZE        128
+#define DIVE_STORE_SLOTS            (DIVE_LOG_SECTOR_SIZE / DIVE_STORE_SLOT_SIZE)
+#define DIVE_STORE_CAPACITY         (DIVE_STORE_SECTORS * (DIVE_STORE_SLOTS - 1))
+#define DIVE_STORE_RECORD_HEADER    12
+#define DIVE_STORE_MAX_RECORD       (DIVE_STORE_SLOT_SIZE - DIVE_STORE_RECORD_HEADER)
+#define DIVE_STORE_NO_SECTOR        0xFF
+
+#define DIVE_STORE_SUMMARY_FIRST_SECTOR     (DIVE_STORE_FIRST_SECTOR + DIVE_STORE_SECTORS)
+#define DIVE_STORE_SUMMARY_SECTORS          32
+#define DIVE_STORE_SUMMARY_SIZE             32
+#define DIVE_STORE_SUMMARIES_PER_SECTOR     (DIVE_LOG_SECTOR_SIZE / DIVE_STORE_SUMMARY_SIZE)
+#define DIVE_STORE_SUMMARY_ENTRIES          (DIVE_STORE_SUMMARY_SECTORS * DIVE_STORE_SUMMARIES_PER_SECTOR)
+#define DIVE_STORE_SUMMARY_RETAINED         (DIVE_STORE_SUMMARY_ENTRIES - DIVE_STORE_SUMMARIES_PER_SECTOR)
+
+// Secteur vu au montage (sequence 0 : libre ou illisible)
+typedef struct {
+    uint32_t sequence;
+    uint32_t first_dive;
+    uint16_t erase_count;
+} DiveStoreSector;
+
+// Résumé d'une plongée (en-tête de DiveProfile, unités entières)
+typedef struct {
+    uint32_t ordinal;           // Rang de l'enregistrement (rempli par le journal)
+    uint32_t dive_number;       // 0 : entrée absente ou illisible
+    uint32_t start_rtc;         // Heure RTC (Unix)
+    uint32_t end_rtc;
+    uint32_t duration;          // Secondes
+    int16_t max_depth;          // cm
+    int16_t avg_depth;          // cm
+    int16_t min_temperature;    // 0.1°C
+    uint16_t max_cns;           // %
+    uint8_t deco_violations;
+    uint8_t reserved;
+    uint16_t crc;               // CRC-32 tronqué, sur les 30 octets précédents (rempli par le journal)
+} DiveSummary;
+
+typedef struct {
+    DiveStoreSector sectors[DIVE_STORE_SECTORS];
+    uint8_t active;             // Secteur en écriture (DIVE_STORE_NO_SECTOR : journal vide)
+    uint8_t next_slot;          // Prochain emplacement libre du secteur actif
+    uint32_t sequence;          // Dernière séquence attribuée
+    uint32_t last_dive;         // Numéro de la dernière plongée lisible
+    uint32_t summaries;         // Rang de cette plongée + 1 (0 : aucune)
+} DiveStore;
+
+// Montage : faux si la flash n'a pas pu être lue (journal alors vu vide)
+bool DiveStore_Mount(DiveStore* store);
+
+// Ajout d'un enregistrement (au plus DIVE_STORE_MAX_RECORD octets) à la suite
+// du journal, puis de son résumé ; faux si l'enregistrement n'est pas écrit
+bool DiveStore_Append(DiveStore* store, uint32_t dive_number, const void* data, uint16_t size,
+                      const DiveSummary* summary);
+
+// Enregistrement d'une plongée, de taille size exactement (faux : absent,
+// effacé ou illisible)
+bool DiveStore_Find(const DiveStore* store, uint32_t dive_number, void* data, uint16_t size);
+
+// Numéros des plongées lisibles, de la plus récente à la plus ancienne ; renvoie le nombre écrit
+uint16_t DiveStore_List(const DiveStore* store, uint32_t* dive_numbers, uint16_t max_count);
+
+// Résumé de la dernière plongée, réécrit s'il a été perdu (coupure entre
+// l'enregistrement et son résumé) ; faux s'il reste illisible
+bool DiveStore_RepairSummary(DiveStore* store, const DiveSummary* summary);
+
+// Entrées consultables de la table (plongées récentes, trous compris)
+uint32_t DiveStore_SummaryCount(const DiveStore* store);
+
+// Entrées de rang [first, first + count), 0 : la plus récente ; une lecture
+// flash (deux au bouclage de la table). Renvoie le nombre écrit ; les entrées
+// absentes ou illisibles ont dive_number à 0.
+uint16_t DiveStore_ReadSummaries(const DiveStore* store, uint32_t first, DiveSummary* summaries,
+                                 uint16_t count);
+
+// Enregistrement de ce rang de la table (entrée illisible : résumé à refaire
+// depuis le profil) ; faux si le rang n'a pas d'enregistrement lisible
+bool DiveStore_FindRank(const DiveStore* store, uint32_t rank, void* data, uint16_t size);
+
+#endif
\ No newline at end of file
@@ -10,6 +10,7 @@
 #define EXTERNAL_ADC_I2C_ADDR 0x48
 #define DISPLAY_SPI_CS_PIN GPIO_PIN_4
 #define BUZZER_PWM_CHANNEL TIM_CHANNEL_1
+#define HAL_DEEP_SLEEP_WAKEUP_S 4   // Réveil RTC en veille profonde (< délai du watchdog, 5 s)
 
 // Types de boutons
 typedef enum {
@@ -117,12 +118,14 @@ float HAL_GetBatteryVoltage(void);
 uint8_t HAL_GetBatteryPercent(void);
 bool HAL_IsCharging(void);
 void HAL_EnterSleepMode(void);
-void HAL_EnterDeepSleepMode(void);
+void HAL_EnterDeepSleepMode(void);      // Retour au réveil RTC suivant (SysTick arrêtée)
 
 // Stockage Flash
 bool HAL_FlashWrite(uint32_t address, uint8_t* data, uint32_t size);
 bool HAL_FlashRead(uint32_t address, uint8_t* data, uint32_t size);
 bool HAL_FlashEraseSector(uint32_t sector);
+bool HAL_FlashEraseSectorStart(uint32_t sector);    // Sans attendre la fin (bit BUSY)
+bool HAL_FlashIsBusy(void);
 uint32_t HAL_FlashGetFreeSpace(void);
 
 // RTC (Real Time Clock)
@@ -138,6 +141,7 @@ void HAL_WatchdogFeed(void);
 
 // Utilitaires système
 uint32_t HAL_GetSysTick(void);
+uint32_t HAL_GetCycleCount(void);
 void HAL_Delay(uint32_t ms);
 void HAL_GetUID(uint8_t* uid);
 float HAL_GetCPUTemperature(void);
@@ -3,25 +3,9 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "ui_state.h"
 #include "dive_computer.h"
 
-// Types d'écrans
-typedef enum {
-    SCREEN_MAIN_DIVE,
-    SCREEN_COMPASS,
-    SCREEN_DECO_INFO,
-    SCREEN_GAS_LIST,
-    SCREEN_CCR_MONITOR,
-    SCREEN_DIVE_PROFILE,
-    SCREEN_TISSUE_GRAPH,
-    SCREEN_MENU_MAIN,
-    SCREEN_MENU_GAS,
-    SCREEN_MENU_DECO,
-    SCREEN_MENU_SYSTEM,
-    SCREEN_LOGBOOK,
-    SCREEN_INFO
-} ScreenType;
-
 // Couleurs (RGB565)
 #define COLOR_BLACK     0x0000
 #define COLOR_WHITE     0xFFFF
@@ -39,22 +23,22 @@ typedef enum {
 #define SCREEN_WIDTH    320
 #define SCREEN_HEIGHT   240
 
-// Structure écran
+// Carnet : lignes par écran (une page flash de résumés)
+#define UI_LOGBOOK_ROWS 8
+
+// Structure écran (table constante, l'état par instance est dans UIState)
 typedef struct {
-    ScreenType type;
     void (*draw)(DiveComputer* dc);
     void (*update)(DiveComputer* dc);
     void (*handle_button)(DiveComputer* dc, ButtonEvent event);
-    uint32_t last_update;
-    bool needs_redraw;
 } Screen;
 
 // Fonctions d'écran principales
-void UI_Init(void);
+void UI_Init(DiveComputer* dc);
 void UI_Update(DiveComputer* dc);
 void UI_HandleButton(DiveComputer* dc, ButtonEvent event);
-void UI_SwitchScreen(ScreenType screen);
-void UI_ForceRedraw(void);
+void UI_SwitchScreen(DiveComputer* dc, ScreenType screen);
+void UI_ForceRedraw(DiveComputer* dc);
 
 // Écrans de plongée
 void UI_DrawMainDiveScreen(DiveComputer* dc);
@@ -93,8 +77,8 @@ void UI_DrawDiveProfile(uint16_t x, uint16_t y, DiveProfile* profile);
 void UI_DrawPressureGraph(uint16_t x, uint16_t y, float* data, uint16_t count);
 
 // Alarmes visuelles
-void UI_ShowAlarm(const char* message, uint8_t severity);
-void UI_ClearAlarm(void);
+void UI_ShowAlarm(DiveComputer* dc, const char* message, uint8_t severity);
+void UI_ClearAlarm(DiveComputer* dc);
 void UI_FlashScreen(uint16_t color);
 
 // Utilitaires
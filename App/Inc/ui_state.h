@@ -0,0 +1,36 @@
+#ifndef UI_STATE_H
+#define UI_STATE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Types d'écrans
+typedef enum {
+    SCREEN_MAIN_DIVE,
+    SCREEN_COMPASS,
+    SCREEN_DECO_INFO,
+    SCREEN_GAS_LIST,
+    SCREEN_CCR_MONITOR,
+    SCREEN_DIVE_PROFILE,
+    SCREEN_TISSUE_GRAPH,
+    SCREEN_MENU_MAIN,
+    SCREEN_MENU_GAS,
+    SCREEN_MENU_DECO,
+    SCREEN_MENU_SYSTEM,
+    SCREEN_LOGBOOK,
+    SCREEN_INFO,
+    SCREEN_COUNT
+} ScreenType;
+
+// État de l'interface, porté par chaque DiveComputer
+typedef struct {
+    ScreenType current_screen;
+    bool needs_redraw[SCREEN_COUNT];    // Par écran
+    uint32_t last_update[SCREEN_COUNT];
+    bool needs_full_redraw;
+    uint32_t last_alarm_time;
+    char alarm_message[64];
+    uint32_t logbook_first;             // Rang de la première plongée affichée (0 : plus récente)
+} UIState;
+
+#endif
\ No newline at end of file
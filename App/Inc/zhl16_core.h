@@ -8,19 +8,89 @@
 #define NUM_COMPARTMENTS 16
 #define MAX_GASES 10
 #define MAX_DECO_STOPS 20
+#define ZHL16_DECAY_CACHE_SIZE 4   // Pas de temps récurrents mémorisés (1 s, intervalle en palier stable...)
+#define ZHL16_ALL_GASES ((uint16_t)((1u << MAX_GASES) - 1))
+#define ZHL16_NO_GAS 0xFF
+#define WHATIF_EXTRA_TIME_S 300    // Scénario "+5 min à la profondeur actuelle"
+#define ZHL16_SWITCH_MAX_BOUNDS (2 * MAX_GASES)    // Bornes de la table de changement de gaz
 
-// Structure compartiment tissulaire
+// Validité du plan publié (recalcul complet au-delà de ces seuils)
+#define PLAN_DEPTH_QUANTUM_M     1.0    // Pas de quantification de la profondeur
+#define PLAN_PPO2_TOLERANCE_BAR  0.05   // Écart de ppO2 (CCR) toléré
+#define PLAN_MAX_AGE_S           60     // Âge max au palier (plan avancé par le temps écoulé)
+#define PLAN_MAX_AGE_MOVING_S    10     // Âge max hors palier
+
+// NDL : instants d'atteinte de la M-value de surface mémorisés par compartiment
+#define NDL_MAX_MIN                 999.0f  // NDL affiché au-delà : illimité
+#define NDL_INSPIRED_FALL_BAR       0.005   // Baisse de pression inspirée tolérée (~5 cm, NDL prudent)
+#define NDL_INSPIRED_RISE_BAR       0.00005 // Hausse tolérée (bruit) : NDL sinon surestimé
+#define NDL_CACHE_MAX_GAP_S         2       // Écart max entre deux appels pour réutiliser
+
+// Intervalle de surface : avance des tissus d'un bloc, désaturation, interdiction de vol
+#define SURFACE_MAX_STEP_S          86400   // Pas max d'une avance (exposant 64 bits en virgule fixe)
+#define DESAT_EXCESS_BAR            0.03f   // Sursaturation N2 + He résiduelle tenue pour désaturée
+#define NOFLY_CABIN_PRESSURE_BAR    0.75f   // Cabine pressurisée (~2400 m)
+// Interdiction de vol minimale après la sortie, quels que soient les tissus
+// (recommandations DAN) : le calcul à la pression cabine seul l'annule dès
+// que les tissus rapides ont dégazé
+#define NOFLY_MIN_SINGLE_MIN        (12 * 60.0f)    // Plongée unique sans palier
+#define NOFLY_MIN_REPETITIVE_MIN    (18 * 60.0f)    // Plongée successive (tissus pas désaturés)
+#define NOFLY_MIN_DECO_MIN          (24 * 60.0f)    // Plongée avec paliers obligatoires
+
+// Représentation des tissus : float, ou virgule fixe avec -DZHL16_FIXED_POINT
+// (cibles sans FPU, voir zhl16_fixed.h). L'API reste en float.
+#ifdef ZHL16_FIXED_POINT
+#include "zhl16_fixed.h"
+typedef q16_t zhl16_real_t;         // Coefficients a/b, saturation %
+typedef q24_t zhl16_pressure_t;     // Pressions tissulaires
+typedef q30_t zhl16_fraction_t;     // Constantes k, facteurs exp(-k*t)
+#define ZHL16_REAL(x)           Q16_FROM_FLOAT(x)
+#define ZHL16_REAL_F(x)         Q16_TO_FLOAT(x)
+#define ZHL16_PRESSURE(x)       Q24_FROM_FLOAT(x)
+#define ZHL16_PRESSURE_F(x)     Q24_TO_FLOAT(x)
+#define ZHL16_FRACTION(x)       Q30_FROM_FLOAT(x)
+#define ZHL16_FRACTION_F(x)     Q30_TO_FLOAT(x)
+#else
+typedef float zhl16_real_t;
+typedef float zhl16_pressure_t;
+typedef float zhl16_fraction_t;
+#define ZHL16_REAL(x)           (x)
+#define ZHL16_REAL_F(x)         (x)
+#define ZHL16_PRESSURE(x)       (x)
+#define ZHL16_PRESSURE_F(x)     (x)
+#define ZHL16_FRACTION(x)       (x)
+#define ZHL16_FRACTION_F(x)     (x)
+#endif
+
+// Coefficients constants des 16 compartiments (structure de tableaux, en flash)
+typedef struct {
+    float half_time_N2[NUM_COMPARTMENTS];
+    float half_time_He[NUM_COMPARTMENTS];
+    zhl16_fraction_t k_N2[NUM_COMPARTMENTS];    // ln2 / demi-période N2 (min^-1)
+    zhl16_fraction_t k_He[NUM_COMPARTMENTS];    // ln2 / demi-période He (min^-1)
+    zhl16_real_t a_N2[NUM_COMPARTMENTS];
+    zhl16_real_t b_N2[NUM_COMPARTMENTS];
+    zhl16_real_t a_He[NUM_COMPARTMENTS];
+    zhl16_real_t b_He[NUM_COMPARTMENTS];
+} ZHL16Coefficients;
+
+// État tissulaire mutable (structure de tableaux, une voie par compartiment)
+typedef struct {
+    zhl16_pressure_t pressure_N2[NUM_COMPARTMENTS];
+    zhl16_pressure_t pressure_He[NUM_COMPARTMENTS];
+    zhl16_real_t loading[NUM_COMPARTMENTS];     // % de saturation
+    zhl16_real_t a_mix[NUM_COMPARTMENTS];       // a pondéré N2/He (ZHL16K_UpdateMix)
+    zhl16_real_t inv_b_mix[NUM_COMPARTMENTS];   // 1/b pondéré N2/He
+} TissueState;
+
+// Facteurs de décroissance de Schreiner exp(-k*t) pour un pas de temps donné
 typedef struct {
-    float half_time_N2;
-    float half_time_He;
-    float a_N2;
-    float b_N2;
-    float a_He;
-    float b_He;
-    float pressure_N2;
-    float pressure_He;
-    float loading;          // % de saturation
-} Compartment;
+    float time_seconds;
+    zhl16_fraction_t factor_N2[NUM_COMPARTMENTS];
+    zhl16_fraction_t factor_He[NUM_COMPARTMENTS];
+    uint32_t last_use;      // Horodatage LRU (compteur d'accès)
+    bool valid;
+} DecayFactors;
 
 // Structure mélange gazeux
 typedef struct {
@@ -53,6 +123,65 @@ typedef struct {
     bool is_valid;
 } AscendPlan;
 
+// Scénarios "what-if" calculés sur le même instantané que le plan courant
+typedef enum {
+    WHATIF_LOST_GAS,        // Perte du premier gaz de déco du plan courant
+    WHATIF_EXTRA_TIME,      // +5 min à la profondeur actuelle
+    WHATIF_BAILOUT,         // Passage en circuit ouvert sur les gaz bailout
+    WHATIF_COUNT
+} WhatIfScenario;
+
+// Entrées du dernier plan complet (détection de changement)
+typedef struct {
+    int16_t depth_step;         // Profondeur quantifiée (PLAN_DEPTH_QUANTUM_M)
+    uint8_t gas;
+    bool ccr_mode;
+    float ppO2;
+    float gf_low;
+    float gf_high;
+    uint32_t computed_at;       // dive_time_seconds au calcul
+    uint32_t advanced_at;       // dive_time_seconds à la dernière avance
+    uint16_t stop_elapsed;      // Secondes de palier pas encore décomptées du TTS
+    bool valid;
+} ZHL16PlanInputs;
+
+// Instants (minutes de plongée) où chaque compartiment atteint la M-value de
+// surface à pression inspirée constante, et leurs facteurs exp(-k·t) : table de
+// logarithmes mémorisée, reprise comme point de départ à chaque changement
+typedef struct {
+    float crossing_min[NUM_COMPARTMENTS];   // Borne basse si non directeur, 1e9 si jamais atteinte
+    float decay_N2[NUM_COMPARTMENTS];       // exp(-k·t) de l'atteinte vue de solved_at (< 0 : inconnu)
+    float decay_He[NUM_COMPARTMENTS];
+    float inspired_N2;
+    float inspired_He;
+    float gf;
+    uint32_t solved_at;         // dive_time_seconds à la dernière résolution
+    uint32_t checked_at;        // dive_time_seconds au dernier appel
+    uint8_t leading;            // Compartiment directeur (résolu en premier)
+    bool valid;
+} ZHL16NDLCache;
+
+// Dernière passe plafond, réutilisée tant que tissus, profondeur et GF ne
+// changent pas, et ancre de la droite des gradient factors
+typedef struct {
+    float anchor_depth;     // Premier palier au GF bas (le plus profond de la plongée)
+    float gf;               // GF appliqué au dernier calcul (fraction)
+    float gf_low;
+    bool valid;
+} ZHL16CeilingState;
+
+// Table de changement de gaz : segments de profondeur ]bound[s-1], bound[s]]
+// sur lesquels l'ensemble des gaz respirables (ppO2 dans les limites) est
+// constant. Reconstruite à chaque changement de la liste des gaz.
+typedef struct {
+    float bound[ZHL16_SWITCH_MAX_BOUNDS];               // Profondeurs croissantes (m)
+    uint16_t breathable[ZHL16_SWITCH_MAX_BOUNDS + 1];   // Gaz respirables du segment (bit par gaz)
+    uint8_t best[ZHL16_SWITCH_MAX_BOUNDS + 1];          // ppO2 la plus haute (ZHL16_NO_GAS : aucun)
+    uint8_t order[MAX_GASES];                           // Gaz activés par fO2 décroissante
+    uint8_t num_bounds;
+    uint8_t num_ordered;
+} ZHL16GasSchedule;
+
 // Configuration décompression
 typedef struct {
     float gf_low;
@@ -69,10 +198,14 @@ typedef struct {
 
 // Structure principale ZHL-16
 typedef struct {
-    Compartment compartments[NUM_COMPARTMENTS];
+    const ZHL16Coefficients* coeffs;    // ZHL16B_Coefficients ou ZHL16C_Coefficients
+    TissueState tissues;
+    DecayFactors decay_cache[ZHL16_DECAY_CACHE_SIZE];
+    uint32_t decay_cache_clock;
     GasMix gases[MAX_GASES];
     uint8_t current_gas;
     uint8_t num_gases;
+    ZHL16GasSchedule gas_schedule;
     DecoConfig config;
     
     // État de plongée
@@ -81,6 +214,7 @@ typedef struct {
     float average_depth;
     uint32_t dive_time_seconds;
     float ambient_pressure;
+    float tissue_ambient_pressure;  // Pression ambiante à la dernière mise à jour des tissus
     float surface_pressure;
     float water_vapor_pressure;
     
@@ -89,7 +223,16 @@ typedef struct {
     float ndl;              // No Deco Limit
     float cns;              // CNS O2 toxicity
     float otu;              // OTU O2 toxicity
+    float desat_time;       // Minutes avant désaturation (intervalle de surface)
+    float nofly_time;       // Minutes avant de pouvoir prendre l'avion
+    float nofly_minimum;    // Minutes restantes de l'interdiction minimale (NOFLY_MIN_*)
+    bool repetitive_dive;   // Plongée commencée avant désaturation ou fin de l'interdiction
     AscendPlan ascend_plan;
+    AscendPlan what_if[WHATIF_COUNT];
+    uint8_t what_if_lost_gas;   // Gaz retiré du scénario WHATIF_LOST_GAS (ZHL16_NO_GAS si aucun)
+    ZHL16PlanInputs plan_inputs;
+    ZHL16NDLCache ndl_cache;
+    ZHL16CeilingState ceiling_state;
     
     // Mode recycleur
     bool ccr_mode;
@@ -97,36 +240,111 @@ typedef struct {
     float actual_ppO2;      // ppO2 réelle mesurée
     
     // Statistiques
-    float gf_current;
-    float gf_surface;
+    float gf_current;       // GF99 : % du gradient de M-value atteint à la profondeur actuelle
+    float gf_surface;       // GF atteint en cas de remontée immédiate en surface
     uint8_t leading_compartment;
     float saturation_percent;
+    uint32_t plan_full_count;   // Plans calculés complètement
+    uint32_t plan_reuse_count;  // Plans réutilisés (avancés du temps écoulé)
+    uint32_t ndl_solve_count;   // NDL résolus complètement (hors cache)
 } ZHL16Model;
 
-// Tables ZHL-16B/C
-extern const float ZHL16B_N2_halftimes[NUM_COMPARTMENTS];
-extern const float ZHL16B_He_halftimes[NUM_COMPARTMENTS];
-extern const float ZHL16B_N2_a[NUM_COMPARTMENTS];
-extern const float ZHL16B_N2_b[NUM_COMPARTMENTS];
-extern const float ZHL16C_N2_halftimes[NUM_COMPARTMENTS];
-extern const float ZHL16C_N2_a[NUM_COMPARTMENTS];
-extern const float ZHL16C_N2_b[NUM_COMPARTMENTS];
+// Étapes du planificateur de remontée découpé en tranches
+typedef enum {
+    PLANNER_IDLE,
+    PLANNER_FIRST_LEG,
+    PLANNER_STOPS,
+    PLANNER_FINAL_ASCENT,
+    PLANNER_DONE
+} PlannerPhase;
+
+// État de simulation compact du planificateur : seules les grandeurs modifiées
+typedef struct {
+    TissueState tissues;
+    float ambient_pressure;
+    float actual_ppO2;
+    float gf;                   // Gradient factor du palier en cours (fraction)
+    float gf_anchor;            // Profondeur du GF bas (premier palier)
+    uint16_t gas_mask;          // Gaz utilisables (bit par gaz)
+    uint8_t current_gas;
+    bool ccr_mode;
+} ZHL16PlannerState;
+
+// Calcul de plan résumable
+typedef struct {
+    PlannerPhase phase;
+    ZHL16PlannerState sim;
+    float current_depth;
+    float total_time;           // Minutes (arrondies une seule fois, à la publication)
+    uint32_t worst_step;        // Pire étape observée (unité de l'horloge), divisée par 2 à chaque Begin
+    DecayFactors stop_decay;    // Facteurs du palier ou de la remontée en cours (hors pile, hors cache)
+    DecayFactors leg_decay;     // Facteurs de la remontée d'un palier au suivant
+    AscendPlan plan;            // Plan en construction
+    bool bailout;               // Publié dans what_if[WHATIF_BAILOUT] au lieu d'ascend_plan
+} ZHL16PlannerJob;
+
+// Plan courant et scénarios what-if calculés en une passe
+typedef struct {
+    ZHL16PlannerJob job;            // Scénario en cours de calcul
+    ZHL16PlannerJob fork;           // Plan courant figé avant son premier changement de gaz
+    ZHL16PlannerState snapshot;     // Instantané commun à tous les scénarios
+    float start_depth;
+    uint32_t worst_step;            // Pire durée d'étape observée, divisée par 2 à chaque Begin
+    uint8_t what_if;                // Scénario en cours une fois le plan courant publié
+    uint8_t lost_gas;
+    bool forked;
+    bool current_done;
+    bool busy;
+} ZHL16ScenarioJob;
+
+// Tables ZHL-16B/C (constantes k et a/b He incluses)
+extern const ZHL16Coefficients ZHL16B_Coefficients;
+extern const ZHL16Coefficients ZHL16C_Coefficients;
 
 // Fonctions principales
 void ZHL16_Init(ZHL16Model* model, float surface_pressure, bool use_zhl16c);
 void ZHL16_Reset(ZHL16Model* model);
+void ZHL16_BeginDive(ZHL16Model* model);
+void ZHL16_EndDive(ZHL16Model* model);
+void ZHL16_SetModel(ZHL16Model* model, bool use_zhl16c);
 void ZHL16_UpdateTissues(ZHL16Model* model, float time_seconds);
+void ZHL16_UpdateTissuesLinear(ZHL16Model* model, float start_ambient, float end_ambient,
+                               float time_seconds);
+void ZHL16_UpdateTissuesLinearOnce(ZHL16Model* model, float start_ambient, float end_ambient,
+                                   float time_seconds);
 void ZHL16_UpdateDepth(ZHL16Model* model, float depth_meters);
 float ZHL16_GetCeiling(ZHL16Model* model);
 float ZHL16_GetNDL(ZHL16Model* model);
-void ZHL16_CalculateAscendPlan(ZHL16Model* model);
+void ZHL16_CalculateAscendPlan(ZHL16PlannerJob* job, ZHL16Model* model);
 bool ZHL16_NeedsDecoStop(ZHL16Model* model);
 
+// Validité du plan publié
+bool ZHL16_PlanIsCurrent(ZHL16Model* model);
+void ZHL16_InvalidatePlan(ZHL16Model* model);
+
+// Planificateur résumable
+void ZHL16_PlannerBegin(ZHL16PlannerJob* job, ZHL16Model* model);
+void ZHL16_PlannerBeginBailout(ZHL16PlannerJob* job, ZHL16Model* model);
+bool ZHL16_PlannerStep(ZHL16PlannerJob* job, ZHL16Model* model);
+bool ZHL16_PlannerRun(ZHL16PlannerJob* job, ZHL16Model* model, uint32_t budget,
+                      uint32_t (*get_time)(void));
+void ZHL16_PlannerPublish(ZHL16PlannerJob* job, ZHL16Model* model);
+
+// Scénarios what-if (chaque plan est publié dès qu'il est complet)
+void ZHL16_ScenariosBegin(ZHL16ScenarioJob* batch, ZHL16Model* model);
+bool ZHL16_ScenariosStep(ZHL16ScenarioJob* batch, ZHL16Model* model);
+bool ZHL16_ScenariosRun(ZHL16ScenarioJob* batch, ZHL16Model* model, uint32_t budget,
+                        uint32_t (*get_time)(void));
+
 // Gestion des gaz
 void ZHL16_AddGas(ZHL16Model* model, uint8_t idx, const char* name, 
                   float fO2, float fN2, float fHe, bool is_diluent);
 bool ZHL16_SwitchGas(ZHL16Model* model, uint8_t gas_idx);
 uint8_t ZHL16_GetBestGas(ZHL16Model* model, float depth);
+void ZHL16_SetGasLimits(ZHL16Model* model, uint8_t idx, float ppO2_min, float ppO2_max);
+void ZHL16_EnableGas(ZHL16Model* model, uint8_t idx, bool enabled);
+void ZHL16_BuildGasSchedule(ZHL16Model* model);
+float ZHL16_GetSwitchDepth(const ZHL16Model* model, uint8_t gas_idx);
 float ZHL16_CalculateMOD(float fO2, float ppO2_max);
 float ZHL16_CalculateEND(float depth, float fN2);
 
@@ -135,6 +353,11 @@ void ZHL16_SetCCRMode(ZHL16Model* model, bool enable, float setpoint);
 void ZHL16_UpdateCCRppO2(ZHL16Model* model, float measured_ppO2);
 void ZHL16_SwitchToBailout(ZHL16Model* model);
 
+// Intervalle de surface
+void ZHL16_SurfaceInterval(ZHL16Model* model, uint32_t seconds);
+float ZHL16_GetDesatTime(ZHL16Model* model);
+float ZHL16_GetNoFlyTime(ZHL16Model* model);
+
 // Toxicité O2
 void ZHL16_UpdateCNS(ZHL16Model* model, float time_seconds);
 void ZHL16_UpdateOTU(ZHL16Model* model, float time_seconds);
@@ -144,6 +367,10 @@ float ZHL16_GetCNSAtDepth(float ppO2);
 void ZHL16_SetGradientFactors(ZHL16Model* model, float gf_low, float gf_high);
 float ZHL16_GetCurrentGF(ZHL16Model* model);
 
+// Cache des facteurs de décroissance
+const DecayFactors* ZHL16_GetDecayFactors(ZHL16Model* model, float time_seconds);
+void ZHL16_InvalidateDecayCache(ZHL16Model* model);
+
 // Utilitaires
 float ZHL16_GetAmbientPressure(float depth, float surface_pressure);
 float ZHL16_GetPartialPressure(float ambient_pressure, float fraction);
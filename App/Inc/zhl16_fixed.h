@@ -0,0 +1,57 @@
+#ifndef ZHL16_FIXED_H
+#define ZHL16_FIXED_H
+
+#include <stdint.h>
+
+// Arithmétique virgule fixe du moteur ZHL-16 (build -DZHL16_FIXED_POINT)
+//
+// Formats :
+//   q16_t  Q16.16  coefficients a/b, saturation %, gradient factor
+//   q24_t  Q8.24   pressions tissulaires et inspirées (bar, ±128 bar)
+//   q30_t  Q2.30   constantes k (min^-1) et facteurs exp(-k*t)
+// Les pressions tissulaires sont en Q8.24 et non Q16.16 : à 1 s de pas, le
+// compartiment le plus lent ne bouge que de ~1e-5 bar, soit moins d'un LSB Q16.16.
+//
+// Budget d'erreur (vérifié par Tools/zhl16_fixed_check.c) :
+//   exp(-x)      <= 4 LSB Q2.30 (4e-9) sur [0, 32[ : (1 - f) du compartiment
+//                   le plus lent à 1 s juste à 2e-4 près (demi-période effective)
+//   ln(x)        <= 4 LSB Q8.24 (2.4e-7) : NDL et paliers à < 0.01 min près
+//   mise à jour  arrondi au plus proche, <= 0.5 LSB Q8.24 par pas : < 2.2e-4 bar
+//                après 2 h de pas de 1 s même si toutes les erreurs s'ajoutent
+//   a/b          <= 0.5 LSB Q16.16 (7.6e-6) : pression tolérée à ~1e-5 bar
+//   plafond      ~1e-4 bar (1 mm) : l'arrondi au palier de 3 m ne change qu'en limite
+// Face au moteur float, l'écart est dominé par le float lui-même : exp(-k*t) en
+// simple précision ne garde que 2-3 chiffres de (1 - f) pour les compartiments lents.
+
+typedef int32_t q16_t;
+typedef int32_t q24_t;
+typedef int32_t q30_t;
+
+#define Q16_ONE     ((q16_t)1 << 16)
+#define Q24_ONE     ((q24_t)1 << 24)
+#define Q30_ONE     ((q30_t)1 << 30)
+
+// Conversions (interface du moteur et initialisation uniquement)
+#define Q16_FROM_FLOAT(x)   ((q16_t)((x) * 65536.0f + ((x) >= 0 ? 0.5f : -0.5f)))
+#define Q24_FROM_FLOAT(x)   ((q24_t)((x) * 16777216.0f + ((x) >= 0 ? 0.5f : -0.5f)))
+#define Q30_FROM_FLOAT(x)   ((q30_t)((x) * 1073741824.0f + ((x) >= 0 ? 0.5f : -0.5f)))
+#define Q16_TO_FLOAT(x)     ((float)(x) * (1.0f / 65536.0f))
+#define Q24_TO_FLOAT(x)     ((float)(x) * (1.0f / 16777216.0f))
+#define Q30_TO_FLOAT(x)     ((float)(x) * (1.0f / 1073741824.0f))
+
+// Multiplications arrondies au plus proche (produit 64 bits, SMULL sur Cortex-M)
+static inline q16_t Q16_Mul(q16_t a, q16_t b) {
+    return (q16_t)(((int64_t)a * b + (1 << 15)) >> 16);
+}
+
+static inline q24_t Q24_MulQ30(q24_t a, q30_t f) {
+    return (q24_t)(((int64_t)a * f + (1 << 29)) >> 30);
+}
+
+// exp(-x) pour x >= 0 en Q2.30 (x en Q2.30 sur 64 bits : k*t peut dépasser 2)
+q30_t Q30_ExpNeg(int64_t x);
+
+// ln(x) pour x > 0, entrée et sortie en Q8.24
+q24_t Q24_Log(q24_t x);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef ZHL16_KERNEL_H
+#define ZHL16_KERNEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "zhl16_core.h"
+
+// Chemin vectoriel sélectionné à la compilation
+#if defined(ZHL16_FIXED_POINT)
+#define ZHL16K_PATH_NAME "Fixed point"
+#elif defined(__AVX__)
+#define ZHL16K_PATH_NAME "AVX"
+#elif defined(__SSE2__)
+#define ZHL16K_PATH_NAME "SSE2"
+#elif defined(__ARM_FP) && defined(__ARM_FEATURE_FMA)
+#define ZHL16K_PATH_NAME "Cortex-M4 FPU"
+#else
+#define ZHL16K_PATH_NAME "Scalar"
+#endif
+
+// Tolérance relative vectoriel / référence scalaire (FMA arrondit différemment)
+#define ZHL16K_SELFTEST_TOLERANCE 1e-5f
+
+// Résultat de la passe plafond (pressions en bar, GF en %)
+typedef struct {
+    float tolerated;        // Pression ambiante tolérée max au GF appliqué
+    float tolerated_low;    // Idem au GF bas (profondeur du premier palier)
+    float gf99;             // GF atteint à la pression ambiante actuelle
+    float gf_surface;       // GF atteint si l'on faisait surface maintenant
+} ZHL16KCeiling;
+
+// Noyaux 16 voies (chemin vectoriel de la cible)
+void ZHL16K_UpdateTissues(TissueState* tissues, const DecayFactors* decay,
+                          float inspired_N2, float inspired_He);
+void ZHL16K_UpdateTissuesLinear(TissueState* tissues, const DecayFactors* decay,
+                                const ZHL16Coefficients* coeffs,
+                                float inspired_N2, float inspired_He,
+                                float rate_N2, float rate_He);
+void ZHL16K_UpdateMix(TissueState* tissues, const ZHL16Coefficients* coeffs);
+float ZHL16K_UpdateLoading(TissueState* tissues, float ambient_pressure, uint8_t* leading);
+float ZHL16K_MaxToleratedPressure(const TissueState* tissues, float gf);
+void ZHL16K_CeilingPass(const TissueState* tissues, float gf, float gf_low,
+                        float ambient_pressure, float surface_pressure, ZHL16KCeiling* out);
+
+// Référence scalaire (toujours compilée, sert de contrôle)
+void ZHL16K_UpdateTissues_Ref(TissueState* tissues, const DecayFactors* decay,
+                              float inspired_N2, float inspired_He);
+void ZHL16K_UpdateTissuesLinear_Ref(TissueState* tissues, const DecayFactors* decay,
+                                    const ZHL16Coefficients* coeffs,
+                                    float inspired_N2, float inspired_He,
+                                    float rate_N2, float rate_He);
+void ZHL16K_UpdateMix_Ref(TissueState* tissues, const ZHL16Coefficients* coeffs);
+float ZHL16K_UpdateLoading_Ref(TissueState* tissues, float ambient_pressure, uint8_t* leading);
+float ZHL16K_MaxToleratedPressure_Ref(const TissueState* tissues, float gf);
+void ZHL16K_CeilingPass_Ref(const TissueState* tissues, float gf, float gf_low,
+                            float ambient_pressure, float surface_pressure, ZHL16KCeiling* out);
+
+// Auto-test : compare le chemin vectoriel à la référence scalaire
+bool ZHL16K_SelfTest(const ZHL16Coefficients* coeffs, float tolerance);
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef ZHL16_TOX_H
+#define ZHL16_TOX_H
+
+#include <stdint.h>
+
+// Toxicité de l'oxygène : taux CNS (limites NOAA) et OTU interpolés dans des
+// tables en flash, sans branche ni puissance à l'exécution
+#define TOX_PPO2_MIN        0.5f    // bar : pas de toxicité en dessous
+#define CNS_TABLE_STEP      0.1f    // bar entre deux points de la table NOAA
+#define CNS_TABLE_POINTS    13      // 0.5 à 1.7 bar
+#define OTU_TABLE_STEP      0.05f   // bar entre deux points de la table OTU
+#define OTU_TABLE_POINTS    41      // 0.5 à 2.5 bar
+#define CNS_HALF_TIME_MIN   90.0f   // Élimination du CNS en surface
+#define OTU_HALF_TIME_MIN   1440.0f // Récupération pulmonaire (dose sur ~24 h glissantes)
+
+// Taux d'exposition
+float ZHL16T_CNSRate(float ppO2);       // % CNS par minute
+float ZHL16T_OTURate(float ppO2);       // OTU par minute, ((ppO2 - 0.5) / 0.5)^0.83
+
+// Facteurs de décroissance sur une durée (intervalle de surface de plusieurs jours compris)
+float ZHL16T_CNSDecay(float seconds);
+float ZHL16T_OTUDecay(float seconds);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "dive_codec.h"
+#include <string.h>
+
+// Un en-tête tient dans le tampon d'un enregistrement
+typedef char DiveCodec_HeaderFitsRecord[DIVE_CODEC_HEADER_SIZE <= DIVE_CODEC_MAX_RECORD ? 1 : -1];
+
+// Entiers variables : 7 bits par octet, bit 7 = suite
+static uint16_t DiveCodec_PutVarint(uint8_t* out, uint32_t value) {
+    uint16_t size = 0;
+    while (value >= 0x80) {
+        out[size++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[size++] = (uint8_t)value;
+    return size;
+}
+
+static bool DiveCodec_GetVarint(const uint8_t* block, uint16_t* pos, uint32_t* value) {
+    uint32_t result = 0;
+    for (uint8_t shift = 0; shift < 32; shift += 7) {
+        if (*pos >= DIVE_CODEC_BLOCK_SIZE) return false;
+        uint8_t byte = block[(*pos)++];
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Zigzag : petits deltas de signe quelconque en petits entiers positifs
+static uint32_t DiveCodec_Zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t DiveCodec_Unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static void DiveCodec_Put16(uint8_t* out, uint16_t value) {
+    out[0] = (uint8_t)value;
+    out[1] = (uint8_t)(value >> 8);
+}
+
+static uint16_t DiveCodec_Get16(const uint8_t* in) {
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint16_t DiveCodec_EncodeHeader(uint16_t dive, uint32_t index, const DiveSample* sample,
+                                       uint8_t* out) {
+    out[0] = DIVE_CODEC_BLOCK_MARKER;
+    DiveCodec_Put16(&out[1], dive);
+    out[3] = (uint8_t)index;
+    out[4] = (uint8_t)(index >> 8);
+    out[5] = (uint8_t)(index >> 16);
+    DiveCodec_Put16(&out[6], sample->time);
+    DiveCodec_Put16(&out[8], (uint16_t)sample->depth);
+    DiveCodec_Put16(&out[10], (uint16_t)sample->temperature);
+    out[12] = sample->gas_idx;
+    out[13] = sample->deco_time;
+    out[14] = sample->cns;
+    DiveCodec_Put16(&out[15], sample->events);
+    return DIVE_CODEC_HEADER_SIZE;
+}
+
+static uint16_t DiveCodec_EncodeRecord(const DiveSample* last, const DiveSample* sample, uint8_t* out) {
+    uint16_t dt = (uint16_t)(sample->time - last->time);
+    int32_t d_depth = sample->depth - last->depth;
+    int32_t d_temp = sample->temperature - last->temperature;
+    uint8_t tag = 0;
+    uint16_t size = 1;
+    
+    if (dt != 1) {
+        tag |= DIVE_CODEC_TIME;
+        size += DiveCodec_PutVarint(&out[size], (uint16_t)(dt - 1));
+    }
+    if (d_depth != 0) {
+        tag |= DIVE_CODEC_DEPTH;
+        size += DiveCodec_PutVarint(&out[size], DiveCodec_Zigzag(d_depth));
+    }
+    if (d_temp != 0) {
+        tag |= DIVE_CODEC_TEMP;
+        size += DiveCodec_PutVarint(&out[size], DiveCodec_Zigzag(d_temp));
+    }
+    if (sample->gas_idx != last->gas_idx) {
+        tag |= DIVE_CODEC_GAS;
+        out[size++] = sample->gas_idx;
+    }
+    if (sample->deco_time != last->deco_time) {
+        tag |= DIVE_CODEC_DECO;
+        out[size++] = sample->deco_time;
+    }
+    if (sample->cns != last->cns) {
+        tag |= DIVE_CODEC_CNS;
+        out[size++] = sample->cns;
+    }
+    if (sample->events != last->events) {
+        tag |= DIVE_CODEC_EVENTS;
+        size += DiveCodec_PutVarint(&out[size], sample->events);
+    }
+    
+    out[0] = tag;
+    return size;
+}
+
+void DiveCodec_Init(DiveCodec* codec, uint32_t dive_number) {
+    memset(codec, 0, sizeof(DiveCodec));
+    codec->dive = (uint16_t)dive_number;
+}
+
+uint16_t DiveCodec_Encode(DiveCodec* codec, const DiveSample* sample, uint8_t* out, bool* new_block) {
+    uint16_t size = 0;
+    
+    *new_block = false;
+    if (codec->block_used > 0) {
+        size = DiveCodec_EncodeRecord(&codec->last, sample, out);
+        if (codec->block_used + size > DIVE_CODEC_BLOCK_SIZE) {
+            size = 0;
+            *new_block = true;
+        }
+    }
+    
+    // Nouveau bloc : en-tête avec l'échantillon en clair
+    if (size == 0) {
+        size = DiveCodec_EncodeHeader(codec->dive, codec->samples, sample, out);
+        codec->block_used = 0;
+    }
+    
+    codec->block_used += size;
+    codec->last = *sample;
+    codec->samples++;
+    return size;
+}
+
+bool DiveCodec_BlockIndex(const uint8_t* block, uint32_t dive_number, uint32_t* first_index) {
+    if (block[0] != DIVE_CODEC_BLOCK_MARKER) return false;
+    if (DiveCodec_Get16(&block[1]) != (uint16_t)dive_number) return false;
+    
+    *first_index = block[3] | ((uint32_t)block[4] << 8) | ((uint32_t)block[5] << 16);
+    return true;
+}
+
+// Enregistrement à block[*pos] appliqué à sample ; faux si tronqué
+static bool DiveCodec_DecodeRecord(const uint8_t* block, uint16_t* pos, DiveSample* sample) {
+    uint8_t tag = block[(*pos)++];
+    uint32_t value;
+    
+    if (tag & DIVE_CODEC_TIME) {
+        if (!DiveCodec_GetVarint(block, pos, &value)) return false;
+        sample->time += (uint16_t)(value + 1);
+    } else {
+        sample->time++;
+    }
+    if (tag & DIVE_CODEC_DEPTH) {
+        if (!DiveCodec_GetVarint(block, pos, &value)) return false;
+        sample->depth = (int16_t)(sample->depth + DiveCodec_Unzigzag(value));
+    }
+    if (tag & DIVE_CODEC_TEMP) {
+        if (!DiveCodec_GetVarint(block, pos, &value)) return false;
+        sample->temperature = (int16_t)(sample->temperature + DiveCodec_Unzigzag(value));
+    }
+    
+    uint16_t bytes = (tag & DIVE_CODEC_GAS ? 1 : 0) + (tag & DIVE_CODEC_DECO ? 1 : 0) +
+                     (tag & DIVE_CODEC_CNS ? 1 : 0);
+    if (*pos + bytes > DIVE_CODEC_BLOCK_SIZE) return false;
+    if (tag & DIVE_CODEC_GAS) sample->gas_idx = block[(*pos)++];
+    if (tag & DIVE_CODEC_DECO) sample->deco_time = block[(*pos)++];
+    if (tag & DIVE_CODEC_CNS) sample->cns = block[(*pos)++];
+    
+    if (tag & DIVE_CODEC_EVENTS) {
+        if (!DiveCodec_GetVarint(block, pos, &value)) return false;
+        sample->events = (uint16_t)value;
+    }
+    
+    return true;
+}
+
+uint16_t DiveCodec_DecodeBlock(const uint8_t* block, uint32_t dive_number, uint16_t skip,
+                               DiveSample* samples, uint16_t max, uint16_t* block_samples) {
+    DiveSample sample;
+    uint32_t first_index;
+    uint16_t pos = DIVE_CODEC_HEADER_SIZE;
+    uint16_t count = 0;
+    uint16_t stored = 0;
+    
+    *block_samples = 0;
+    if (!DiveCodec_BlockIndex(block, dive_number, &first_index)) return 0;
+    
+    sample.time = DiveCodec_Get16(&block[6]);
+    sample.depth = (int16_t)DiveCodec_Get16(&block[8]);
+    sample.temperature = (int16_t)DiveCodec_Get16(&block[10]);
+    sample.gas_idx = block[12];
+    sample.deco_time = block[13];
+    sample.cns = block[14];
+    sample.events = DiveCodec_Get16(&block[15]);
+    
+    for (;;) {
+        if (count >= skip && stored < max) {
+            samples[stored++] = sample;
+        }
+        count++;
+        
+        if (pos >= DIVE_CODEC_BLOCK_SIZE || (block[pos] & DIVE_CODEC_END)) break;
+        if (!DiveCodec_DecodeRecord(block, &pos, &sample)) break;
+    }
+    
+    *block_samples = count;
+    return stored;
+}
\ No newline at end of file
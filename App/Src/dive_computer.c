@@ -1,9 +1,13 @@
 #include "dive_computer.h"
-
-// Instance globale
-static DiveComputer g_dive_computer;
+#include "ui_screens.h"
+#include "zhl16_kernel.h"
+#include <math.h>
+#include <string.h>
 
 void DiveComputer_Init(DiveComputer* dc) {
+    // Tout l'état vit dans l'instance : remise à zéro complète
+    memset(dc, 0, sizeof(DiveComputer));
+    
     // Initialisation matérielle
     HAL_InitHardware();
     
@@ -18,7 +22,7 @@ void DiveComputer_Init(DiveComputer* dc) {
     ZHL16_Init(&dc->zhl16, surface_pressure, false); // ZHL-16B par défaut
     DiveManager_Init(&dc->dive);
     CCR_Init(&dc->ccr);
-    UI_Init();
+    UI_Init(dc);
     
     // Configuration des gaz par défaut
     ZHL16_AddGas(&dc->zhl16, 0, "Air", 0.21, 0.79, 0.0, false);
@@ -29,6 +33,14 @@ void DiveComputer_Init(DiveComputer* dc) {
     dc->mode = MODE_SURFACE;
     dc->in_dive = false;
     dc->emergency_mode = false;
+    dc->activity_ms = HAL_GetSysTick();
+
+#ifndef NDEBUG
+    // Build de mise au point : noyaux de la cible contre la référence scalaire
+    if (!ZHL16K_SelfTest(dc->zhl16.coeffs, ZHL16K_SELFTEST_TOLERANCE)) {
+        dc->emergency_mode = true;
+    }
+#endif
 }
 
 void DiveComputer_Update(DiveComputer* dc) {
@@ -83,28 +95,91 @@ void DiveComputer_Update(DiveComputer* dc) {
     HAL_WatchdogFeed();
 }
 
+// Intègre les secondes en attente (avant tout changement de gaz ou de mode).
+// Seuls les pas récurrents (1 s en remontée, TISSUE_STEADY_MAX_INTERVAL_S en
+// palier stable) passent par le cache des facteurs ; les reliquats sont ponctuels
+static void DiveComputer_FlushTissues(DiveComputer* dc) {
+    if (dc->tissue_pending_s == 0) return;
+    
+    if (dc->tissue_pending_s == 1 || dc->tissue_pending_s == TISSUE_STEADY_MAX_INTERVAL_S) {
+        ZHL16_UpdateTissuesLinear(&dc->zhl16, dc->zhl16.tissue_ambient_pressure,
+                                  dc->zhl16.ambient_pressure, dc->tissue_pending_s);
+    } else {
+        ZHL16_UpdateTissuesLinearOnce(&dc->zhl16, dc->zhl16.tissue_ambient_pressure,
+                                      dc->zhl16.ambient_pressure, dc->tissue_pending_s);
+    }
+    dc->tissue_pending_s = 0;
+}
+
+// Intervalle de surface : tissus avancés d'un bloc depuis l'heure RTC de la
+// dernière avance (toutes les SURFACE_UPDATE_INTERVAL_S, ou tout de suite au
+// réveil), puis plafond, désaturation et interdiction de vol
+static void DiveComputer_SurfaceUpdate(DiveComputer* dc, bool force) {
+    uint32_t now = HAL_RTCGetUnixTime();
+    
+    if (dc->surface_rtc == 0 || now < dc->surface_rtc) {
+        // Fin de plongée (ou RTC remise à l'heure) : départ de l'intervalle,
+        // plans en cours abandonnés
+        DiveComputer_FlushTissues(dc);
+        dc->planner.busy = false;
+        dc->bailout_planner.phase = PLANNER_IDLE;
+        dc->bailout_age_s = 0;
+        dc->surface_rtc = now;
+        force = true;
+    }
+    if (!force && now - dc->surface_rtc < SURFACE_UPDATE_INTERVAL_S) return;
+    
+    ZHL16_SurfaceInterval(&dc->zhl16, now - dc->surface_rtc);
+    dc->surface_rtc = now;
+    ZHL16_GetCeiling(&dc->zhl16);
+    ZHL16_GetDesatTime(&dc->zhl16);
+    ZHL16_GetNoFlyTime(&dc->zhl16);
+}
+
 void DiveComputer_1HzTasks(DiveComputer* dc) {
     // Tâches exécutées chaque seconde
-    static uint32_t last_second = 0;
     uint32_t now = HAL_GetSysTick() / 1000;
     
-    if (now == last_second) return;
-    last_second = now;
+    if (now == dc->last_second) return;
+    dc->last_second = now;
     
-    // Mise à jour des tissus (1 seconde)
+    // Mise à jour des tissus : intégration linéaire depuis la pression de la
+    // dernière mise à jour, espacée jusqu'à TISSUE_STEADY_MAX_INTERVAL_S en palier stable
     if (dc->dive.is_diving) {
-        ZHL16_UpdateTissues(&dc->zhl16, 1.0);
+        dc->activity_ms = HAL_GetSysTick();
+        dc->tissue_pending_s++;
+        
+        float pressure_delta = fabsf(dc->zhl16.ambient_pressure - dc->zhl16.tissue_ambient_pressure);
+        if (pressure_delta >= TISSUE_STEADY_DELTA_BAR ||
+            dc->tissue_pending_s >= TISSUE_STEADY_MAX_INTERVAL_S ||
+            dc->zhl16.ccr_mode) {
+            DiveComputer_FlushTissues(dc);
+        }
         ZHL16_UpdateCNS(&dc->zhl16, 1.0);
+        ZHL16_UpdateOTU(&dc->zhl16, 1.0);
         
         // Calcul du plafond
         ZHL16_GetCeiling(&dc->zhl16);
         
-        // Calcul NDL ou plan de remontée
+        // Calcul NDL ou plans de remontée (tranches dans DiveComputer_BackgroundTasks)
         if (dc->zhl16.ceiling > 0) {
-            ZHL16_CalculateAscendPlan(&dc->zhl16);
+            // Recalcul complet seulement si le plan publié n'est plus valable
+            if (!dc->planner.busy && !ZHL16_PlanIsCurrent(&dc->zhl16)) {
+                ZHL16_ScenariosBegin(&dc->planner, &dc->zhl16);
+            }
         } else {
             ZHL16_GetNDL(&dc->zhl16);
         }
+        
+        // Plan bailout gardé au chaud en CCR, même sans palier
+        if (dc->mode == MODE_CCR && dc->bailout_planner.phase == PLANNER_IDLE &&
+            ++dc->bailout_age_s >= BAILOUT_REFRESH_S) {
+            ZHL16_PlannerBeginBailout(&dc->bailout_planner, &dc->zhl16);
+            dc->bailout_age_s = 0;
+        }
+        dc->surface_rtc = 0;
+    } else {
+        DiveComputer_SurfaceUpdate(dc, false);
     }
     
     // Auto setpoint CCR
@@ -126,75 +201,171 @@ void DiveComputer_10HzTasks(DiveComputer* dc) {
     }
 }
 
+void DiveComputer_BackgroundTasks(DiveComputer* dc) {
+    // Page d'échantillons en attente vers la flash
+    DiveLog_Service(&dc->dive.log);
+    
+    // Tranche des plans de remontée, bornée à PLANNER_SLICE_BUDGET_US (en
+    // plongée seulement : un plan fini après la sortie serait périmé)
+    if (!dc->dive.is_diving) return;
+    
+    uint32_t budget = PLANNER_SLICE_BUDGET_US * (SystemCoreClock / 1000000);
+    ZHL16_ScenariosRun(&dc->planner, &dc->zhl16, budget, HAL_GetCycleCount);
+    
+    // Plan bailout : seulement quand les plans prioritaires sont à jour
+    if (!dc->planner.busy) {
+        ZHL16_PlannerRun(&dc->bailout_planner, &dc->zhl16, budget, HAL_GetCycleCount);
+    }
+}
+
+// Veille profonde permise : surface, aucune plongée en cours ni en détection,
+// journal écrit et DEEP_SLEEP_IDLE_S sans activité
+bool DiveComputer_CanDeepSleep(const DiveComputer* dc) {
+    return dc->mode == MODE_SURFACE && !dc->dive.is_diving && !dc->emergency_mode &&
+           dc->dive.start_detect_time == 0 && !dc->dive.log.pending && !dc->dive.log.erasing &&
+           HAL_GetSysTick() - dc->activity_ms >= DEEP_SLEEP_IDLE_S * 1000u;
+}
+
+// Retour de veille profonde (la SysTick était arrêtée, seule la RTC a compté) :
+// lecture des capteurs (début de plongée), puis rattrapage de l'intervalle de
+// surface dès qu'une période SURFACE_UPDATE_INTERVAL_S s'est écoulée à la RTC,
+// avant tout affichage
+void DiveComputer_Wake(DiveComputer* dc) {
+    uint32_t surface_rtc = dc->surface_rtc;
+    
+    DiveComputer_Update(dc);
+    if (!dc->dive.is_diving) {
+        DiveComputer_SurfaceUpdate(dc, false);
+    }
+    if (dc->surface_rtc != surface_rtc) {
+        UI_ForceRedraw(dc);
+    }
+}
+
 void DiveComputer_HandleButton(DiveComputer* dc, ButtonEvent event) {
+    dc->activity_ms = HAL_GetSysTick();
+    
     switch (event) {
         case BUTTON_MENU:
             if (dc->mode == MODE_SURFACE) {
-                UI_SwitchScreen(SCREEN_MENU_MAIN);
+                UI_SwitchScreen(dc, SCREEN_MENU_MAIN);
             }
             break;
-            
+        
         case BUTTON_UP:
             // Navigation ou changement de gaz
             if (dc->dive.is_diving) {
                 uint8_t next_gas = (dc->zhl16.current_gas + 1) % dc->zhl16.num_gases;
+                DiveComputer_FlushTissues(dc);
                 ZHL16_SwitchGas(&dc->zhl16, next_gas);
+            } else if (dc->ui.current_screen == SCREEN_LOGBOOK && dc->ui.logbook_first > 0) {
+                dc->ui.logbook_first -= dc->ui.logbook_first < UI_LOGBOOK_ROWS ? dc->ui.logbook_first
+                                                                                : UI_LOGBOOK_ROWS;
+                dc->ui.needs_redraw[SCREEN_LOGBOOK] = true;
             }
             break;
-            
+        
         case BUTTON_DOWN:
-            // Navigation
+            // Navigation (carnet : page suivante, plus anciennes)
+            if (dc->ui.current_screen == SCREEN_LOGBOOK &&
+                dc->ui.logbook_first + UI_LOGBOOK_ROWS < DiveManager_GetLogbookSize(&dc->dive)) {
+                dc->ui.logbook_first += UI_LOGBOOK_ROWS;
+                dc->ui.needs_redraw[SCREEN_LOGBOOK] = true;
+            }
             break;
-            
+        
         case BUTTON_ENTER:
             // Validation
             break;
-            
+        
         case BUTTON_MENU_LONG:
             // Changement de mode
             if (dc->mode == MODE_CCR) {
                 DiveComputer_SwitchMode(dc, MODE_BAILOUT);
             }
             break;
-            
+        
         case BUTTON_ENTER_LONG:
             // Reset alarme ou marqueur
-            if (ui_state.alarm_message[0]) {
-                UI_ClearAlarm();
+            if (dc->ui.alarm_message[0]) {
+                UI_ClearAlarm(dc);
             }
             break;
     }
 }
 
 void DiveComputer_SwitchMode(DiveComputer* dc, DiveMode new_mode) {
+    DiveComputer_FlushTissues(dc);
     dc->previous_mode = dc->mode;
     dc->mode = new_mode;
     
     switch (new_mode) {
         case MODE_CCR:
             ZHL16_SetCCRMode(&dc->zhl16, true, dc->ccr.current_setpoint);
+            dc->bailout_age_s = BAILOUT_REFRESH_S;  // Plan bailout dès la prochaine seconde
             break;
-            
+        
         case MODE_BAILOUT:
             CCR_SwitchToBailout(&dc->ccr, 0); // Premier gaz bailout
             ZHL16_SwitchToBailout(&dc->zhl16);
-            UI_ShowAlarm("BAILOUT!", 2);
+            // Plan circuit ouvert tenu à jour : basculé d'un bloc (même contexte
+            // que sa publication, aucune interruption n'y touche). Les calculs
+            // en cours, encore CCR, sont abandonnés.
+            if (dc->zhl16.what_if[WHATIF_BAILOUT].is_valid) {
+                dc->zhl16.ascend_plan = dc->zhl16.what_if[WHATIF_BAILOUT];
+            }
+            dc->planner.busy = false;
+            dc->bailout_planner.phase = PLANNER_IDLE;
+            UI_ShowAlarm(dc, "BAILOUT!", 2);
             break;
-            
+        
         case MODE_GAUGE:
             // Mode profondimètre simple
             break;
-            
+        
         default:
             break;
     }
     
-    UI_ForceRedraw();
+    UI_ForceRedraw(dc);
+}
+
+// Un passage de la boucle principale : tâches dont l'échéance SysTick est atteinte,
+// puis calculs de fond (boucle de main(), rejouée telle quelle par les simulateurs hôte)
+void DiveComputer_RunOnce(DiveComputer* dc) {
+    uint32_t now = HAL_GetSysTick();
+    
+    // Mise à jour principale (50Hz)
+    if (now - dc->last_update_ms >= 20) {
+        dc->last_update_ms = now;
+        DiveComputer_Update(dc);
+    }
+    
+    // Tâches 10Hz
+    if (now - dc->last_100ms >= 100) {
+        dc->last_100ms = now;
+        DiveComputer_10HzTasks(dc);
+    }
+    
+    // Tâches 1Hz
+    if (now - dc->last_1s >= 1000) {
+        dc->last_1s = now;
+        DiveComputer_1HzTasks(dc);
+    }
+    
+    // Calculs de fond entre les tâches périodiques
+    DiveComputer_BackgroundTasks(dc);
 }
 
 // ============================================================================
 // POINT D'ENTRÉE PRINCIPAL
 // ============================================================================
+// HOST_SIMULATION : modules compilés sur l'hôte, boucle fournie par le simulateur
+#ifndef HOST_SIMULATION
+
+// Instance de la cible
+static DiveComputer g_dive_computer;
+
 int main(void) {
     // Initialisation HAL STM32
     HAL_Init();
@@ -207,36 +378,20 @@ int main(void) {
     // Timer 100ms pour mise à jour principale
     // Timer 1s pour calculs décompression
     
-    uint32_t last_update = 0;
-    uint32_t last_100ms = 0;
-    uint32_t last_1s = 0;
-    
     // Boucle principale
     while (1) {
-        uint32_t now = HAL_GetSysTick();
+        DiveComputer_RunOnce(&g_dive_computer);
         
-        // Mise à jour principale (50Hz)
-        if (now - last_update >= 20) {
-            last_update = now;
-            DiveComputer_Update(&g_dive_computer);
-        }
-        
-        // Tâches 10Hz
-        if (now - last_100ms >= 100) {
-            last_100ms = now;
-            DiveComputer_10HzTasks(&g_dive_computer);
-        }
-        
-        // Tâches 1Hz
-        if (now - last_1s >= 1000) {
-            last_1s = now;
-            DiveComputer_1HzTasks(&g_dive_computer);
-        }
-        
-        // Mode économie d'énergie en surface
-        if (!g_dive_computer.dive.is_diving && 
-            g_dive_computer.mode == MODE_SURFACE) {
+        // Mode économie d'énergie en surface : veille profonde une fois
+        // inactif (réveils RTC périodiques), sinon attente d'interruption
+        if (DiveComputer_CanDeepSleep(&g_dive_computer)) {
+            HAL_EnterDeepSleepMode();
+            DiveComputer_Wake(&g_dive_computer);
+        } else if (!g_dive_computer.dive.is_diving && 
+                   g_dive_computer.mode == MODE_SURFACE) {
             __WFI(); // Wait For Interrupt
         }
     }
-}
\ No newline at end of file
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "dive_log.h"
+#include "hardware_hal.h"
+#include <string.h>
+
+uint32_t DiveLog_Wrap(uint32_t address) {
+    if (address >= DIVE_LOG_SAMPLES_END) {
+        address -= DIVE_LOG_SAMPLES_SIZE;
+    }
+    return address;
+}
+
+void DiveLog_Init(DiveLog* log, uint32_t write_address) {
+    memset(log, 0, sizeof(DiveLog));
+    
+    if (write_address < DIVE_LOG_SAMPLES_BASE || write_address >= DIVE_LOG_SAMPLES_END) {
+        write_address = DIVE_LOG_SAMPLES_BASE;
+    }
+    log->write_address = write_address - write_address % DIVE_LOG_PAGE_SIZE;
+}
+
+// Écriture d'une page à write_address. Première page d'un secteur : effacement
+// d'abord (W25Q64 : 45 à 400 ms, une fois toutes les 16 pages), lancé puis
+// sondé ; sans wait, faux tant qu'il n'est pas fini (page à représenter).
+// Adresse avancée même en échec pour ne pas bloquer l'enregistrement sur une
+// page défectueuse.
+static bool DiveLog_ProgramPage(DiveLog* log, uint8_t* page, bool wait) {
+    bool ok = true;
+    
+    if (log->write_address % DIVE_LOG_SECTOR_SIZE == 0) {
+        if (!log->erasing) {
+            ok = HAL_FlashEraseSectorStart(log->write_address / DIVE_LOG_SECTOR_SIZE);
+            log->erasing = ok;
+        }
+        while (log->erasing && HAL_FlashIsBusy()) {
+            if (!wait) return false;
+        }
+        log->erasing = false;
+    }
+    if (ok) {
+        ok = HAL_FlashWrite(log->write_address, page, DIVE_LOG_PAGE_SIZE);
+    }
+    if (!ok) {
+        log->flash_error = true;
+    }
+    
+    log->write_address = DiveLog_Wrap(log->write_address + DIVE_LOG_PAGE_SIZE);
+    return true;
+}
+
+// Page en attente écrite, effacement de son secteur attendu si besoin
+static void DiveLog_Flush(DiveLog* log) {
+    if (!log->pending) return;
+    
+    DiveLog_ProgramPage(log, log->page[log->active ^ 1], true);
+    log->pending = false;
+}
+
+void DiveLog_Begin(DiveLog* log) {
+    log->fill = 0;
+    log->active = 0;
+    log->pending = false;
+    log->erasing = false;
+    log->start = log->write_address;
+    log->bytes = 0;
+    log->recording = true;
+    log->flash_error = false;
+}
+
+bool DiveLog_Append(DiveLog* log, const void* data, uint16_t size) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    
+    if (!log->recording) return false;
+    
+    while (size > 0) {
+        uint16_t chunk = DIVE_LOG_PAGE_SIZE - log->fill;
+        if (chunk > size) chunk = size;
+        
+        memcpy(&log->page[log->active][log->fill], bytes, chunk);
+        log->fill += chunk;
+        log->bytes += chunk;
+        bytes += chunk;
+        size -= chunk;
+        
+        // Page pleine : elle passe en attente, l'autre devient active
+        if (log->fill == DIVE_LOG_PAGE_SIZE) {
+            DiveLog_Flush(log);
+            log->pending = true;
+            log->active ^= 1;
+            log->fill = 0;
+        }
+    }
+    
+    return !log->flash_error;
+}
+
+void DiveLog_PadPage(DiveLog* log) {
+    static const uint8_t erased[16] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+    };
+    
+    if (!log->recording) return;
+    
+    while (log->fill > 0) {
+        uint16_t chunk = DIVE_LOG_PAGE_SIZE - log->fill;
+        if (chunk > sizeof(erased)) chunk = sizeof(erased);
+        DiveLog_Append(log, erased, chunk);
+    }
+}
+
+void DiveLog_Service(DiveLog* log) {
+    if (log->pending && DiveLog_ProgramPage(log, log->page[log->active ^ 1], false)) {
+        log->pending = false;
+    }
+}
+
+void DiveLog_Finish(DiveLog* log) {
+    if (!log->recording) return;
+    
+    DiveLog_Flush(log);
+    
+    // Page partielle complétée à l'état effacé : la plongée suivante commence
+    // sur une page neuve
+    if (log->fill > 0) {
+        memset(&log->page[log->active][log->fill], 0xFF, DIVE_LOG_PAGE_SIZE - log->fill);
+        DiveLog_ProgramPage(log, log->page[log->active], true);
+        log->fill = 0;
+    }
+    
+    log->recording = false;
+}
+
+bool DiveLog_Read(uint32_t start, uint32_t offset, void* data, uint32_t size) {
+    uint8_t* bytes = (uint8_t*)data;
+    uint32_t address = DiveLog_Wrap(start + offset % DIVE_LOG_SAMPLES_SIZE);
+    
+    while (size > 0) {
+        uint32_t chunk = DIVE_LOG_SAMPLES_END - address;
+        if (chunk > size) chunk = size;
+        
+        if (!HAL_FlashRead(address, bytes, chunk)) return false;
+        
+        bytes += chunk;
+        size -= chunk;
+        address = DiveLog_Wrap(address + chunk);
+    }
+    
+    return true;
+}
\ No newline at end of file
@@ -1,6 +1,24 @@
 #include "dive_manager.h"
+#include "hardware_hal.h"
 #include <string.h>
 
+// Un profil tient dans un emplacement du journal
+typedef char DiveManager_ProfileFitsStore[sizeof(DiveProfile) <= DIVE_STORE_MAX_RECORD ? 1 : -1];
+
+// En-tête d'un profil pour la table des résumés du carnet
+static void DiveManager_Summarize(const DiveProfile* profile, DiveSummary* summary) {
+    memset(summary, 0, sizeof(DiveSummary));
+    summary->dive_number = profile->dive_number;
+    summary->start_rtc = profile->start_rtc;
+    summary->end_rtc = profile->end_rtc;
+    summary->duration = profile->duration;
+    summary->max_depth = (int16_t)(profile->max_depth * 100);
+    summary->avg_depth = (int16_t)(profile->avg_depth * 100);
+    summary->min_temperature = (int16_t)(profile->min_temperature * 10);
+    summary->max_cns = (uint16_t)(profile->max_cns + 0.5f);
+    summary->deco_violations = profile->deco_violations;
+}
+
 void DiveManager_Init(DiveManager* dm) {
     memset(dm, 0, sizeof(DiveManager));
     
@@ -10,6 +28,24 @@ void DiveManager_Init(DiveManager* dm) {
     dm->fast_ascent_rate = 18.0; // m/min alarme
     dm->auto_start_dive = true;
     dm->safety_stop_enforce = true;
+    dm->safety_stop_time = SAFETY_STOP_TIME;
+    dm->log_depth_tolerance = LOG_DEPTH_TOLERANCE;
+    
+    // Journal monté : numérotation, résumé de la dernière plongée, et flux d'échantillons repris au secteur
+    // qui suit la dernière plongée (une plongée coupée a pu écrire au-delà)
+    uint32_t samples_address = DIVE_LOG_SAMPLES_BASE;
+    DiveStore_Mount(&dm->store);
+    if (DiveManager_LoadDive(dm, dm->store.last_dive, &dm->current_dive)) {
+        DiveSummary summary;
+        DiveManager_Summarize(&dm->current_dive, &summary);
+        DiveStore_RepairSummary(&dm->store, &summary);
+        
+        uint32_t end = dm->current_dive.samples_address + dm->current_dive.samples_bytes +
+                       DIVE_LOG_SECTOR_SIZE - 1;
+        samples_address = DiveLog_Wrap(end - end % DIVE_LOG_SECTOR_SIZE);
+        memset(&dm->current_dive, 0, sizeof(DiveProfile));
+    }
+    DiveLog_Init(&dm->log, samples_address);
 }
 
 void DiveManager_Update(DiveManager* dm, float depth, float temperature, ZHL16Model* model) {
@@ -19,8 +55,10 @@ void DiveManager_Update(DiveManager* dm, float depth, float temperature, ZHL16Mo
     if (dm->auto_start_dive) {
         if (!dm->is_diving && DiveManager_CheckDiveStart(dm, depth)) {
             DiveManager_StartDive(dm);
+            ZHL16_BeginDive(model);
         } else if (dm->is_diving && DiveManager_CheckDiveEnd(dm, depth)) {
             DiveManager_EndDive(dm);
+            ZHL16_EndDive(model);
         }
     }
     
@@ -76,10 +114,19 @@ void DiveManager_Update(DiveManager* dm, float depth, float temperature, ZHL16Mo
         DiveManager_UpdateSafetyStop(dm, depth);
     }
     
+    // Toxicité O2
+    if (model->cns > dm->current_dive.max_cns) {
+        dm->current_dive.max_cns = model->cns;
+    }
+    if (model->otu > dm->current_dive.max_otu) {
+        dm->current_dive.max_otu = model->otu;
+    }
+    
     // Enregistrement échantillon
     if (now - dm->current_dive.start_timestamp >= dm->sample_counter) {
         DiveManager_RecordSample(dm, depth, temperature, 
-                               model->current_gas, model->ceiling > 0 ? model->ascend_plan.tts : 0);
+                               model->current_gas, model->ceiling > 0 ? model->ascend_plan.tts : 0,
+                               model->cns);
         dm->sample_counter++;
     }
 }
@@ -93,13 +140,21 @@ void DiveManager_StartDive(DiveManager* dm) {
     
     // Initialisation profil
     memset(&dm->current_dive, 0, sizeof(DiveProfile));
-    dm->current_dive.dive_number = DiveManager_GetLastDiveNumber() + 1;
+    dm->current_dive.dive_number = DiveManager_GetLastDiveNumber(dm) + 1;
     dm->current_dive.start_timestamp = now;
+    dm->current_dive.start_rtc = HAL_RTCGetUnixTime();
     dm->current_dive.surface_interval = dm->surface_interval_mins;
     
+    // Flux d'échantillons à la page flash courante
+    DiveLog_Begin(&dm->log);
+    DiveCodec_Init(&dm->codec, dm->current_dive.dive_number);
+    memset(&dm->simplifier, 0, sizeof(DiveSimplifier));
+    dm->current_dive.samples_address = dm->log.start;
+    
     dm->sample_counter = 0;
     dm->avg_depth_sum = 0;
     dm->avg_depth_samples = 0;
+    dm->rate_last_time = 0;
     dm->safety_stop_required = false;
     dm->safety_stop_completed = false;
     dm->safety_stop_timer = 0;
@@ -114,62 +169,63 @@ void DiveManager_EndDive(DiveManager* dm) {
     
     // Finalisation profil
     dm->current_dive.end_timestamp = now;
+    dm->current_dive.end_rtc = HAL_RTCGetUnixTime();
     dm->current_dive.duration = now - dm->current_dive.start_timestamp;
     dm->current_dive.avg_depth = dm->avg_depth_sum / dm->avg_depth_samples;
     
-    // Compression et sauvegarde
-    DiveManager_CompressSamples(dm);
+    // Dernier échantillon retenu, dernière page et sauvegarde
+    DiveManager_FlushSamples(dm);
+    DiveLog_Finish(&dm->log);
+    dm->current_dive.samples_bytes = dm->log.bytes;
     DiveManager_SaveDive(dm);
+    
+    // Alarmes de plongée : plus réévaluées en surface
+    dm->ascent_rate_alarm = false;
+    dm->deco_ceiling_alarm = false;
 }
 
 bool DiveManager_CheckDiveStart(DiveManager* dm, float depth) {
-    static uint32_t start_time = 0;
-    
     if (depth >= DIVE_START_DEPTH) {
-        if (start_time == 0) {
-            start_time = HAL_GetSysTick() / 1000;
-        } else if ((HAL_GetSysTick() / 1000) - start_time >= 20) {
-            start_time = 0;
+        if (dm->start_detect_time == 0) {
+            dm->start_detect_time = HAL_GetSysTick() / 1000;
+        } else if ((HAL_GetSysTick() / 1000) - dm->start_detect_time >= DIVE_START_TIME) {
+            dm->start_detect_time = 0;
             return true;
         }
     } else {
-        start_time = 0;
+        dm->start_detect_time = 0;
     }
     
     return false;
 }
 
 bool DiveManager_CheckDiveEnd(DiveManager* dm, float depth) {
-    static uint32_t surface_time = 0;
-    
     if (depth <= DIVE_END_DEPTH) {
-        if (surface_time == 0) {
-            surface_time = HAL_GetSysTick() / 1000;
-        } else if ((HAL_GetSysTick() / 1000) - surface_time >= DIVE_END_TIME) {
-            surface_time = 0;
+        if (dm->end_detect_time == 0) {
+            dm->end_detect_time = HAL_GetSysTick() / 1000;
+        } else if ((HAL_GetSysTick() / 1000) - dm->end_detect_time >= DIVE_END_TIME) {
+            dm->end_detect_time = 0;
             return true;
         }
     } else {
-        surface_time = 0;
+        dm->end_detect_time = 0;
     }
     
     return false;
 }
 
 void DiveManager_UpdateRates(DiveManager* dm, float depth) {
-    static float last_depth = 0;
-    static uint32_t last_time = 0;
     uint32_t now = HAL_GetSysTick() / 1000;
     
-    if (last_time == 0) {
-        last_time = now;
-        last_depth = depth;
+    if (dm->rate_last_time == 0) {
+        dm->rate_last_time = now;
+        dm->rate_last_depth = depth;
         return;
     }
     
-    float time_delta = (now - last_time) / 60.0; // Minutes
+    float time_delta = (now - dm->rate_last_time) / 60.0; // Minutes
     if (time_delta > 0) {
-        float depth_delta = depth - last_depth;
+        float depth_delta = depth - dm->rate_last_depth;
         float rate = depth_delta / time_delta;
         
         // Filtrage exponentiel
@@ -180,8 +236,8 @@ void DiveManager_UpdateRates(DiveManager* dm, float depth) {
         }
     }
     
-    last_depth = depth;
-    last_time = now;
+    dm->rate_last_depth = depth;
+    dm->rate_last_time = now;
 }
 
 bool DiveManager_CheckAscentRate(DiveManager* dm) {
@@ -198,7 +254,7 @@ void DiveManager_UpdateSafetyStop(DiveManager* dm, float depth) {
     if (dm->phase == PHASE_SAFETY_STOP && dm->safety_stop_required) {
         if (depth >= 4.5 && depth <= 5.5) {
             dm->safety_stop_timer++;
-            if (dm->safety_stop_timer >= dm->config.safety_stop_time) {
+            if (dm->safety_stop_timer >= dm->safety_stop_time) {
                 dm->safety_stop_completed = true;
                 dm->safety_stop_required = false;
             }
@@ -208,19 +264,50 @@ void DiveManager_UpdateSafetyStop(DiveManager* dm, float depth) {
     }
 }
 
-void DiveManager_RecordSample(DiveManager* dm, float depth, float temp, uint8_t gas, uint8_t deco) {
-    if (dm->current_dive.num_samples >= MAX_DIVE_SAMPLES) {
-        DiveManager_CompressSamples(dm);
+// Encodage dans la page RAM, écrite en flash par DiveLog_Service ; un
+// nouveau bloc commence toujours sur une page
+static void DiveManager_WriteSample(DiveManager* dm, const DiveSample* sample) {
+    uint8_t record[DIVE_CODEC_MAX_RECORD];
+    bool new_block;
+    uint16_t size = DiveCodec_Encode(&dm->codec, sample, record, &new_block);
+    if (new_block) {
+        DiveLog_PadPage(&dm->log);
     }
+    DiveLog_Append(&dm->log, record, size);
+    dm->current_dive.num_samples++;
     
-    DiveSample* sample = &dm->current_dive.samples[dm->current_dive.num_samples];
-    sample->time = dm->sample_counter;
-    sample->depth = (int16_t)(depth * 100);
-    sample->temperature = (int16_t)(temp * 10);
-    sample->gas_idx = gas;
-    sample->deco_time = deco;
-    sample->cns = 0; // À implémenter
-    sample->events = 0;
+    dm->simplifier.anchor = *sample;
+    dm->simplifier.has_anchor = true;
+}
+
+// Pentes limites depuis l'ancre pour passer à ±tolérance de sample
+static void DiveManager_DoorSlopes(const DiveSimplifier* simplifier, const DiveSample* sample,
+                                   float tolerance, float* slope_min, float* slope_max) {
+    float dt = (float)(uint16_t)(sample->time - simplifier->anchor.time);
+    float depth = (float)(sample->depth - simplifier->anchor.depth);
+    *slope_min = (depth - tolerance) / dt;
+    *slope_max = (depth + tolerance) / dt;
+}
+
+void DiveManager_RecordSample(DiveManager* dm, float depth, float temp, uint8_t gas, uint8_t deco,
+                              float cns) {
+    DiveSimplifier* simplifier = &dm->simplifier;
+    const DiveSample* previous = simplifier->has_held ? &simplifier->held : &simplifier->anchor;
+    float tolerance = dm->log_depth_tolerance * 100.0f;
+    
+    DiveSample sample;
+    sample.time = dm->sample_counter;
+    sample.depth = (int16_t)(depth * 100);
+    sample.temperature = (int16_t)(temp * 10);
+    sample.gas_idx = gas;
+    sample.deco_time = deco;
+    sample.cns = (uint8_t)(cns + 0.5f);
+    sample.events = 0;
+    
+    if (simplifier->has_anchor && gas != previous->gas_idx) sample.events |= DIVE_EVENT_GAS_SWITCH;
+    if (dm->ascent_rate_alarm) sample.events |= DIVE_EVENT_ASCENT_RATE;
+    if (dm->deco_ceiling_alarm) sample.events |= DIVE_EVENT_CEILING;
+    if (dm->ppO2_alarm) sample.events |= DIVE_EVENT_PPO2;
     
     // Mise à jour des statistiques
     if (depth > dm->current_dive.max_depth) {
@@ -230,15 +317,121 @@ void DiveManager_RecordSample(DiveManager* dm, float depth, float temp, uint8_t
         dm->current_dive.min_temperature = temp;
     }
     
-    dm->current_dive.num_samples++;
+    // Premier échantillon, simplification désactivée, gaz ou événements
+    // changés : écrit d'office, précédé de l'échantillon retenu
+    if (!simplifier->has_anchor || tolerance <= 0.0f || sample.gas_idx != previous->gas_idx ||
+        sample.events != previous->events) {
+        DiveManager_FlushSamples(dm);
+        DiveManager_WriteSample(dm, &sample);
+        return;
+    }
+    
+    float slope_min, slope_max;
+    if (simplifier->has_held) {
+        // La droite vers cet échantillon sort du cône des précédents :
+        // l'échantillon retenu est écrit et devient l'origine
+        float dt = (float)(uint16_t)(sample.time - simplifier->anchor.time);
+        float slope = (float)(sample.depth - simplifier->anchor.depth) / dt;
+        if (slope < simplifier->slope_min || slope > simplifier->slope_max) {
+            DiveManager_WriteSample(dm, &simplifier->held);
+            DiveManager_DoorSlopes(simplifier, &sample, tolerance, &slope_min, &slope_max);
+        } else {
+            DiveManager_DoorSlopes(simplifier, &sample, tolerance, &slope_min, &slope_max);
+            if (slope_min < simplifier->slope_min) slope_min = simplifier->slope_min;
+            if (slope_max > simplifier->slope_max) slope_max = simplifier->slope_max;
+        }
+    } else {
+        DiveManager_DoorSlopes(simplifier, &sample, tolerance, &slope_min, &slope_max);
+    }
+    
+    simplifier->slope_min = slope_min;
+    simplifier->slope_max = slope_max;
+    simplifier->held = sample;
+    simplifier->has_held = true;
+}
+
+// Écrit l'échantillon retenu par la simplification (fin de plongée)
+void DiveManager_FlushSamples(DiveManager* dm) {
+    if (dm->simplifier.has_held) {
+        DiveManager_WriteSample(dm, &dm->simplifier.held);
+        dm->simplifier.has_held = false;
+    }
+}
+
+// Relecture des échantillons d'une plongée terminée ; renvoie le nombre lu.
+// Les blocs illisibles ou d'une autre plongée (écrasés depuis) sont sautés.
+uint16_t DiveManager_ReadSamples(const DiveProfile* profile, uint32_t first, DiveSample* samples,
+                                 uint16_t count) {
+    uint8_t block[DIVE_CODEC_BLOCK_SIZE];
+    uint32_t blocks = (profile->samples_bytes + DIVE_CODEC_BLOCK_SIZE - 1) / DIVE_CODEC_BLOCK_SIZE;
+    uint32_t start_block = 0;
+    uint32_t index;
+    uint16_t read = 0;
+    
+    // Dernier bloc commençant au plus tard à `first` (en-têtes seuls)
+    for (uint32_t b = 0; b < blocks; b++) {
+        if (!DiveLog_Read(profile->samples_address, b * DIVE_CODEC_BLOCK_SIZE, block,
+                          DIVE_CODEC_ID_SIZE)) return 0;
+        if (!DiveCodec_BlockIndex(block, profile->dive_number, &index)) continue;
+        if (index > first) break;
+        start_block = b;
+    }
+    
+    for (uint32_t b = start_block; b < blocks && read < count; b++) {
+        uint16_t block_samples;
+        if (!DiveLog_Read(profile->samples_address, b * DIVE_CODEC_BLOCK_SIZE, block,
+                          DIVE_CODEC_BLOCK_SIZE)) break;
+        if (!DiveCodec_BlockIndex(block, profile->dive_number, &index)) continue;
+        
+        uint32_t next = first + read;
+        uint16_t skip = next > index ? (uint16_t)(next - index) : 0;
+        read += DiveCodec_DecodeBlock(block, profile->dive_number, skip, &samples[read], count - read,
+                                      &block_samples);
+    }
+    
+    return read;
 }
 
-void DiveManager_CompressSamples(DiveManager* dm) {
-    // Compression simple : garder 1 échantillon sur 2
-    uint16_t j = 0;
-    for (uint16_t i = 0; i < dm->current_dive.num_samples; i += 2) {
-        dm->current_dive.samples[j] = dm->current_dive.samples[i];
-        j++;
+// Journal de plongée (voir dive_store.h)
+bool DiveManager_SaveDive(DiveManager* dm) {
+    DiveSummary summary;
+    DiveManager_Summarize(&dm->current_dive, &summary);
+    return DiveStore_Append(&dm->store, dm->current_dive.dive_number, &dm->current_dive,
+                            sizeof(DiveProfile), &summary);
+}
+
+bool DiveManager_LoadDive(DiveManager* dm, uint32_t dive_number, DiveProfile* profile) {
+    return DiveStore_Find(&dm->store, dive_number, profile, sizeof(DiveProfile));
+}
+
+uint32_t DiveManager_GetLastDiveNumber(DiveManager* dm) {
+    return dm->store.last_dive;
+}
+
+// Plus récentes d'abord, 0 au-delà de la dernière plongée lisible
+void DiveManager_GetDiveList(DiveManager* dm, uint32_t* dive_numbers, uint8_t max_count) {
+    uint16_t count = DiveStore_List(&dm->store, dive_numbers, max_count);
+    while (count < max_count) {
+        dive_numbers[count++] = 0;
     }
-    dm->current_dive.num_samples = j;
+}
+
+// Carnet : résumés de rang [first, first + count), plus récents d'abord. Une
+// entrée illisible (coupure pendant son écriture) est refaite depuis le
+// profil ; dive_number à 0 si le rang n'a pas de plongée.
+uint16_t DiveManager_GetLogbookPage(DiveManager* dm, uint32_t first, DiveSummary* entries, uint16_t count) {
+    DiveProfile profile;
+    uint16_t read = DiveStore_ReadSummaries(&dm->store, first, entries, count);
+    
+    for (uint16_t i = 0; i < read; i++) {
+        if (entries[i].dive_number == 0 &&
+            DiveStore_FindRank(&dm->store, first + i, &profile, sizeof(DiveProfile))) {
+            DiveManager_Summarize(&profile, &entries[i]);
+        }
+    }
+    return read;
+}
+
+uint32_t DiveManager_GetLogbookSize(DiveManager* dm) {
+    return DiveStore_SummaryCount(&dm->store);
 }
\ No newline at end of file
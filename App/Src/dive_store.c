@@ -0,0 +1,376 @@
+#include "dive_store.h"
+#include "hardware_hal.h"
+#include <string.h>
+
+#define DIVE_STORE_SECTOR_MAGIC     0x5344      // "DS"
+#define DIVE_STORE_RECORD_MAGIC     0x5244      // "DR"
+#define DIVE_STORE_ERASED_MAGIC     0xFFFF
+
+// En-têtes en flash (emplacement 0 du secteur, début de chaque enregistrement)
+typedef struct {
+    uint16_t magic;
+    uint16_t erase_count;
+    uint32_t sequence;
+    uint32_t first_dive;
+    uint32_t crc;               // Sur les 12 octets précédents
+} DiveStoreSectorHeader;
+
+typedef struct {
+    uint16_t magic;
+    uint16_t size;
+    uint32_t dive_number;
+    uint32_t crc;               // Sur les 8 octets précédents puis les données
+} DiveStoreRecordHeader;
+
+// La table des résumés tient entre le journal et le flux d'échantillons
+typedef char DiveStore_SummaryLayout[sizeof(DiveSummary) == DIVE_STORE_SUMMARY_SIZE &&
+                                     (DIVE_STORE_SUMMARY_FIRST_SECTOR + DIVE_STORE_SUMMARY_SECTORS) *
+                                     DIVE_LOG_SECTOR_SIZE <= DIVE_LOG_SAMPLES_BASE ? 1 : -1];
+
+// CRC-32 (polynôme 0xEDB88320), par demi-octet
+static uint32_t DiveStore_Crc(uint32_t crc, const uint8_t* data, uint16_t size) {
+    static const uint32_t table[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+    };
+    
+    crc = ~crc;
+    for (uint16_t i = 0; i < size; i++) {
+        crc = table[(crc ^ data[i]) & 0x0F] ^ (crc >> 4);
+        crc = table[(crc ^ (data[i] >> 4)) & 0x0F] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+static uint32_t DiveStore_Address(uint8_t sector, uint8_t slot) {
+    return (DIVE_STORE_FIRST_SECTOR + sector) * DIVE_LOG_SECTOR_SIZE + slot * DIVE_STORE_SLOT_SIZE;
+}
+
+// Rang d'un enregistrement dans le journal depuis le premier secteur ouvert
+static uint32_t DiveStore_Ordinal(const DiveStore* store, uint8_t sector, uint8_t slot) {
+    return (store->sectors[sector].sequence - 1) * (DIVE_STORE_SLOTS - 1) + slot - 1;
+}
+
+static uint32_t DiveStore_SummaryAddress(uint32_t ordinal) {
+    return DIVE_STORE_SUMMARY_FIRST_SECTOR * DIVE_LOG_SECTOR_SIZE +
+           (ordinal % DIVE_STORE_SUMMARY_ENTRIES) * DIVE_STORE_SUMMARY_SIZE;
+}
+
+static uint16_t DiveStore_SummaryCrc(const DiveSummary* summary) {
+    return (uint16_t)DiveStore_Crc(0, (const uint8_t*)summary, DIVE_STORE_SUMMARY_SIZE - 2);
+}
+
+// Entrée de ce rang, intègre (une entrée d'un tour de table précédent porte
+// un autre rang)
+static bool DiveStore_SummaryValid(const DiveSummary* summary, uint32_t ordinal) {
+    return summary->ordinal == ordinal && summary->crc == DiveStore_SummaryCrc(summary);
+}
+
+// Entrée écrite à la position de son rang ; `erase` : secteur de la table
+// entamé par ce rang, effacé d'abord
+static bool DiveStore_WriteSummary(uint32_t ordinal, const DiveSummary* summary, bool erase) {
+    DiveSummary entry = *summary;
+    uint32_t address = DiveStore_SummaryAddress(ordinal);
+    
+    entry.ordinal = ordinal;
+    entry.reserved = 0xFF;
+    entry.crc = DiveStore_SummaryCrc(&entry);
+    
+    if (erase && !HAL_FlashEraseSector(address / DIVE_LOG_SECTOR_SIZE)) return false;
+    return HAL_FlashWrite(address, (uint8_t*)&entry, sizeof(entry));
+}
+
+// Enregistrement d'un emplacement : en-tête et données (buffer de
+// DIVE_STORE_MAX_RECORD octets), faux si effacé, tronqué ou corrompu
+static bool DiveStore_ReadRecord(uint8_t sector, uint8_t slot, DiveStoreRecordHeader* header,
+                                 uint8_t* buffer) {
+    if (!HAL_FlashRead(DiveStore_Address(sector, slot), (uint8_t*)header, sizeof(DiveStoreRecordHeader))) {
+        return false;
+    }
+    if (header->magic != DIVE_STORE_RECORD_MAGIC || header->size > DIVE_STORE_MAX_RECORD) return false;
+    
+    if (!HAL_FlashRead(DiveStore_Address(sector, slot) + sizeof(DiveStoreRecordHeader), buffer,
+                       header->size)) {
+        return false;
+    }
+    
+    uint32_t crc = DiveStore_Crc(0, (const uint8_t*)header, 8);
+    return DiveStore_Crc(crc, buffer, header->size) == header->crc;
+}
+
+// Secteur ouvert juste avant `sector` (séquence inférieure la plus proche)
+static uint8_t DiveStore_Previous(const DiveStore* store, uint8_t sector) {
+    uint8_t previous = DIVE_STORE_NO_SECTOR;
+    uint32_t best = 0;
+    
+    for (uint8_t s = 0; s < DIVE_STORE_SECTORS; s++) {
+        uint32_t sequence = store->sectors[s].sequence;
+        if (sequence > best && sequence < store->sectors[sector].sequence) {
+            best = sequence;
+            previous = s;
+        }
+    }
+    return previous;
+}
+
+bool DiveStore_Mount(DiveStore* store) {
+    DiveStoreSectorHeader header;
+    DiveStoreRecordHeader record;
+    uint8_t buffer[DIVE_STORE_MAX_RECORD];
+    
+    memset(store, 0, sizeof(DiveStore));
+    store->active = DIVE_STORE_NO_SECTOR;
+    
+    // En-têtes de secteur : index et secteur actif (séquence la plus haute)
+    for (uint8_t s = 0; s < DIVE_STORE_SECTORS; s++) {
+        if (!HAL_FlashRead(DiveStore_Address(s, 0), (uint8_t*)&header, sizeof(header))) {
+            memset(store->sectors, 0, sizeof(store->sectors));
+            store->active = DIVE_STORE_NO_SECTOR;
+            store->sequence = 0;
+            return false;
+        }
+        if (header.magic != DIVE_STORE_SECTOR_MAGIC ||
+            DiveStore_Crc(0, (const uint8_t*)&header, 12) != header.crc) {
+            continue;
+        }
+        
+        store->sectors[s].sequence = header.sequence;
+        store->sectors[s].first_dive = header.first_dive;
+        store->sectors[s].erase_count = header.erase_count;
+        if (header.sequence > store->sequence) {
+            store->sequence = header.sequence;
+            store->active = s;
+        }
+    }
+    
+    if (store->active == DIVE_STORE_NO_SECTOR) return true;
+    
+    // Premier emplacement jamais écrit du secteur actif (un emplacement
+    // commencé puis coupé reste occupé)
+    store->next_slot = DIVE_STORE_SLOTS;
+    for (uint8_t slot = 1; slot < DIVE_STORE_SLOTS; slot++) {
+        if (!HAL_FlashRead(DiveStore_Address(store->active, slot), (uint8_t*)&record, sizeof(record))) {
+            return false;
+        }
+        if (record.magic == DIVE_STORE_ERASED_MAGIC) {
+            store->next_slot = slot;
+            break;
+        }
+    }
+    
+    // Dernière plongée lisible, en remontant au besoin vers les secteurs précédents
+    uint8_t sector = store->active;
+    uint8_t slot = store->next_slot;
+    while (sector != DIVE_STORE_NO_SECTOR) {
+        while (slot > 1) {
+            slot--;
+            if (DiveStore_ReadRecord(sector, slot, &record, buffer)) {
+                store->last_dive = record.dive_number;
+                store->summaries = DiveStore_Ordinal(store, sector, slot) + 1;
+                return true;
+            }
+        }
+        sector = DiveStore_Previous(store, sector);
+        slot = DIVE_STORE_SLOTS;
+    }
+    
+    return true;
+}
+
+// Ouverture du secteur suivant de l'anneau : effacement puis en-tête. En
+// échec, le secteur est sauté à l'ajout suivant.
+static bool DiveStore_OpenSector(DiveStore* store, uint32_t first_dive) {
+    uint8_t sector = store->active == DIVE_STORE_NO_SECTOR ? 0 : (store->active + 1) % DIVE_STORE_SECTORS;
+    DiveStoreSector* entry = &store->sectors[sector];
+    DiveStoreSectorHeader header;
+    
+    header.magic = DIVE_STORE_SECTOR_MAGIC;
+    header.erase_count = entry->erase_count + 1;
+    header.sequence = ++store->sequence;
+    header.first_dive = first_dive;
+    header.crc = DiveStore_Crc(0, (const uint8_t*)&header, 12);
+    
+    store->active = sector;
+    store->next_slot = 1;
+    entry->sequence = 0;
+    entry->erase_count = header.erase_count;
+    
+    if (!HAL_FlashEraseSector(DIVE_STORE_FIRST_SECTOR + sector) ||
+        !HAL_FlashWrite(DiveStore_Address(sector, 0), (uint8_t*)&header, sizeof(header))) {
+        store->next_slot = DIVE_STORE_SLOTS;
+        return false;
+    }
+    
+    entry->sequence = header.sequence;
+    entry->first_dive = first_dive;
+    return true;
+}
+
+bool DiveStore_Append(DiveStore* store, uint32_t dive_number, const void* data, uint16_t size,
+                      const DiveSummary* summary) {
+    uint8_t buffer[DIVE_STORE_SLOT_SIZE];
+    DiveStoreRecordHeader header;
+    
+    if (size > DIVE_STORE_MAX_RECORD) return false;
+    
+    if (store->active == DIVE_STORE_NO_SECTOR || store->next_slot >= DIVE_STORE_SLOTS) {
+        if (!DiveStore_OpenSector(store, dive_number)) return false;
+    }
+    
+    header.magic = DIVE_STORE_RECORD_MAGIC;
+    header.size = size;
+    header.dive_number = dive_number;
+    header.crc = DiveStore_Crc(DiveStore_Crc(0, (const uint8_t*)&header, 8), (const uint8_t*)data, size);
+    
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(&buffer[sizeof(header)], data, size);
+    
+    // Emplacement consommé même en échec : jamais reprogrammé sans effacement
+    uint8_t slot = store->next_slot++;
+    if (!HAL_FlashWrite(DiveStore_Address(store->active, slot), buffer, sizeof(header) + size)) {
+        return false;
+    }
+    
+    store->last_dive = dive_number;
+    
+    // Résumé après l'enregistrement, qui fait foi. Secteur de la table effacé
+    // quand ce rang y entre le premier (rangs sautés compris).
+    uint32_t ordinal = DiveStore_Ordinal(store, store->active, slot);
+    bool erase = store->summaries == 0 ||
+                 ordinal / DIVE_STORE_SUMMARIES_PER_SECTOR !=
+                 (store->summaries - 1) / DIVE_STORE_SUMMARIES_PER_SECTOR;
+    store->summaries = ordinal + 1;
+    DiveStore_WriteSummary(ordinal, summary, erase);
+    return true;
+}
+
+bool DiveStore_Find(const DiveStore* store, uint32_t dive_number, void* data, uint16_t size) {
+    DiveStoreRecordHeader header;
+    uint8_t sector = DIVE_STORE_NO_SECTOR;
+    
+    // Secteur le plus récent commençant au plus tard à cette plongée
+    for (uint8_t s = 0; s < DIVE_STORE_SECTORS; s++) {
+        const DiveStoreSector* entry = &store->sectors[s];
+        if (entry->sequence == 0 || entry->first_dive > dive_number) continue;
+        if (sector == DIVE_STORE_NO_SECTOR || entry->sequence > store->sectors[sector].sequence) {
+            sector = s;
+        }
+    }
+    if (sector == DIVE_STORE_NO_SECTOR) return false;
+    
+    // Numéros consécutifs : emplacement direct, sinon parcours du secteur
+    uint8_t buffer[DIVE_STORE_MAX_RECORD];
+    uint32_t offset = dive_number - store->sectors[sector].first_dive;
+    bool found = offset < DIVE_STORE_SLOTS - 1 &&
+                 DiveStore_ReadRecord(sector, (uint8_t)(offset + 1), &header, buffer) &&
+                 header.dive_number == dive_number;
+    
+    for (uint8_t slot = DIVE_STORE_SLOTS - 1; !found && slot >= 1; slot--) {
+        found = DiveStore_ReadRecord(sector, slot, &header, buffer) && header.dive_number == dive_number;
+    }
+    
+    if (!found || header.size != size) return false;
+    memcpy(data, buffer, size);
+    return true;
+}
+
+uint16_t DiveStore_List(const DiveStore* store, uint32_t* dive_numbers, uint16_t max_count) {
+    DiveStoreRecordHeader header;
+    uint8_t buffer[DIVE_STORE_MAX_RECORD];
+    uint16_t count = 0;
+    uint8_t sector = store->active;
+    uint8_t slot = store->next_slot;
+    
+    while (sector != DIVE_STORE_NO_SECTOR && count < max_count) {
+        while (slot > 1 && count < max_count) {
+            slot--;
+            if (DiveStore_ReadRecord(sector, slot, &header, buffer)) {
+                dive_numbers[count++] = header.dive_number;
+            }
+        }
+        sector = DiveStore_Previous(store, sector);
+        slot = DIVE_STORE_SLOTS;
+    }
+    return count;
+}
+
+bool DiveStore_RepairSummary(DiveStore* store, const DiveSummary* summary) {
+    DiveSummary entry;
+    
+    if (store->summaries == 0) return false;
+    
+    uint32_t ordinal = store->summaries - 1;
+    if (!HAL_FlashRead(DiveStore_SummaryAddress(ordinal), (uint8_t*)&entry, sizeof(entry))) return false;
+    if (DiveStore_SummaryValid(&entry, ordinal)) return true;
+    
+    // Entrée encore effacée : écrite. Sinon (écriture ou effacement coupés),
+    // secteur réeffacé seulement s'il ne porte aucun rang antérieur.
+    bool erased = true;
+    for (uint8_t i = 0; i < sizeof(entry); i++) {
+        if (((const uint8_t*)&entry)[i] != 0xFF) erased = false;
+    }
+    if (!erased && ordinal % DIVE_STORE_SUMMARIES_PER_SECTOR != 0) return false;
+    
+    return DiveStore_WriteSummary(ordinal, summary, !erased);
+}
+
+uint32_t DiveStore_SummaryCount(const DiveStore* store) {
+    return store->summaries < DIVE_STORE_SUMMARY_RETAINED ? store->summaries : DIVE_STORE_SUMMARY_RETAINED;
+}
+
+uint16_t DiveStore_ReadSummaries(const DiveStore* store, uint32_t first, DiveSummary* summaries,
+                                 uint16_t count) {
+    uint32_t available = DiveStore_SummaryCount(store);
+    if (first >= available || count == 0) return 0;
+    if (count > available - first) count = (uint16_t)(available - first);
+    
+    // Rangs décroissants = positions croissantes en flash, de la plus ancienne
+    // de la page à la plus récente, coupées au plus une fois par le bouclage
+    uint32_t newest = store->summaries - 1 - first;
+    uint32_t position = (newest - (count - 1)) % DIVE_STORE_SUMMARY_ENTRIES;
+    uint16_t head = count;
+    if (position + count > DIVE_STORE_SUMMARY_ENTRIES) {
+        head = (uint16_t)(DIVE_STORE_SUMMARY_ENTRIES - position);
+    }
+    
+    if (!HAL_FlashRead(DiveStore_SummaryAddress(position), (uint8_t*)summaries, head * sizeof(DiveSummary))) {
+        return 0;
+    }
+    if (head < count &&
+        !HAL_FlashRead(DiveStore_SummaryAddress(0), (uint8_t*)&summaries[head],
+                       (count - head) * sizeof(DiveSummary))) {
+        return 0;
+    }
+    
+    for (uint16_t i = 0; i < count / 2; i++) {
+        DiveSummary swap = summaries[i];
+        summaries[i] = summaries[count - 1 - i];
+        summaries[count - 1 - i] = swap;
+    }
+    for (uint16_t i = 0; i < count; i++) {
+        if (!DiveStore_SummaryValid(&summaries[i], newest - i)) {
+            summaries[i].dive_number = 0;
+        }
+    }
+    return count;
+}
+
+bool DiveStore_FindRank(const DiveStore* store, uint32_t rank, void* data, uint16_t size) {
+    DiveStoreRecordHeader header;
+    uint8_t buffer[DIVE_STORE_MAX_RECORD];
+    
+    if (rank >= DiveStore_SummaryCount(store)) return false;
+    
+    // Rang -> secteur de cette séquence, puis emplacement
+    uint32_t ordinal = store->summaries - 1 - rank;
+    uint32_t sequence = ordinal / (DIVE_STORE_SLOTS - 1) + 1;
+    for (uint8_t s = 0; s < DIVE_STORE_SECTORS; s++) {
+        if (store->sectors[s].sequence != sequence) continue;
+        
+        uint8_t slot = (uint8_t)(ordinal % (DIVE_STORE_SLOTS - 1) + 1);
+        if (!DiveStore_ReadRecord(s, slot, &header, buffer) || header.size != size) return false;
+        memcpy(data, buffer, size);
+        return true;
+    }
+    return false;
+}
\ No newline at end of file
@@ -17,9 +17,8 @@ static uint32_t button_state = 0;
 static uint32_t button_time[5] = {0};
 static float battery_voltage_filtered = 0;
 
-// Initialisation matérielle globale
-void HAL_InitHardware(void) {
-    // Configuration des horloges
+// Horloges HSE/PLL 168 MHz (aussi au retour du mode STOP, qui repart sur HSI)
+static void HAL_ConfigClocks(void) {
     RCC_OscInitTypeDef RCC_OscInitStruct = {0};
     RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
     
@@ -44,6 +43,17 @@ void HAL_InitHardware(void) {
     RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV4;
     RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV2;
     HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_5);
+}
+
+// Initialisation matérielle globale
+void HAL_InitHardware(void) {
+    // Configuration des horloges
+    HAL_ConfigClocks();
+    
+    // Compteur de cycles DWT (budgets des tâches de fond)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
     
     // Initialisation des périphériques
     HAL_InitPressureSensor();
@@ -258,6 +268,28 @@ void HAL_InitRTC(void) {
     hrtc.Init.OutPutPolarity = RTC_OUTPUT_POLARITY_HIGH;
     hrtc.Init.OutPutType = RTC_OUTPUT_TYPE_OPENDRAIN;
     HAL_RTC_Init(&hrtc);
+    
+    // Réveil périodique de la veille profonde (ligne EXTI 22)
+    HAL_NVIC_SetPriority(RTC_WKUP_IRQn, 0, 0);
+    HAL_NVIC_EnableIRQ(RTC_WKUP_IRQn);
+}
+
+void RTC_WKUP_IRQHandler(void) {
+    HAL_RTCEx_WakeUpTimerIRQHandler(&hrtc);
+}
+
+// Veille profonde (mode STOP, régulateur basse consommation) jusqu'au réveil
+// RTC suivant : la SysTick est arrêtée, seule la RTC compte. Le watchdog
+// continue de tourner en STOP : réveil toutes les HAL_DEEP_SLEEP_WAKEUP_S
+void HAL_EnterDeepSleepMode(void) {
+    HAL_SuspendTick();
+    HAL_RTCEx_SetWakeUpTimer_IT(&hrtc, HAL_DEEP_SLEEP_WAKEUP_S - 1, RTC_WAKEUPCLOCK_CK_SPRE_16BITS);
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+    
+    HAL_RTCEx_DeactivateWakeUpTimer(&hrtc);
+    HAL_ConfigClocks();
+    HAL_ResumeTick();
+    HAL_WatchdogFeed();
 }
 
 uint32_t HAL_RTCGetUnixTime(void) {
@@ -291,4 +323,9 @@ void HAL_WatchdogInit(uint16_t timeout_ms) {
 
 void HAL_WatchdogFeed(void) {
     IWDG->KR = 0xAAAA;
+}
+
+// Compteur de cycles CPU (reboucle toutes les ~25 s à 168 MHz)
+uint32_t HAL_GetCycleCount(void) {
+    return DWT->CYCCNT;
 }
\ No newline at end of file
@@ -1,44 +1,50 @@
 #include "ui_screens.h"
 #include <stdio.h>
+#include <string.h>
 
-// État global UI
-static struct {
-    ScreenType current_screen;
-    Screen screens[16];
-    bool needs_full_redraw;
-    uint32_t last_alarm_time;
-    char alarm_message[64];
-} ui_state;
-
-void UI_Init(void) {
-    memset(&ui_state, 0, sizeof(ui_state));
-    ui_state.current_screen = SCREEN_MAIN_DIVE;
-    ui_state.needs_full_redraw = true;
-    
-    // Configuration des écrans
-    ui_state.screens[SCREEN_MAIN_DIVE].draw = UI_DrawMainDiveScreen;
-    ui_state.screens[SCREEN_CCR_MONITOR].draw = UI_DrawCCRMonitorScreen;
-    ui_state.screens[SCREEN_DECO_INFO].draw = UI_DrawDecoInfoScreen;
+// Écrans disponibles (l'état d'affichage est dans dc->ui)
+static const Screen ui_screens[SCREEN_COUNT] = {
+    [SCREEN_MAIN_DIVE]   = { .draw = UI_DrawMainDiveScreen },
+    [SCREEN_CCR_MONITOR] = { .draw = UI_DrawCCRMonitorScreen },
+    [SCREEN_DECO_INFO]   = { .draw = UI_DrawDecoInfoScreen },
+    [SCREEN_GAS_LIST]    = { .draw = UI_DrawGasListScreen },
+    [SCREEN_LOGBOOK]     = { .draw = UI_DrawLogbook },
     // ... autres écrans
+};
+
+void UI_Init(DiveComputer* dc) {
+    memset(&dc->ui, 0, sizeof(UIState));
+    dc->ui.current_screen = SCREEN_MAIN_DIVE;
+    dc->ui.needs_full_redraw = true;
 }
 
 void UI_Update(DiveComputer* dc) {
-    Screen* screen = &ui_state.screens[ui_state.current_screen];
+    UIState* ui = &dc->ui;
+    const Screen* screen = &ui_screens[ui->current_screen];
     
-    if (ui_state.needs_full_redraw || screen->needs_redraw) {
+    if (ui->needs_full_redraw || ui->needs_redraw[ui->current_screen]) {
         HAL_DisplayClear();
         if (screen->draw) {
             screen->draw(dc);
         }
         HAL_DisplayUpdate();
-        screen->needs_redraw = false;
-        ui_state.needs_full_redraw = false;
+        ui->needs_redraw[ui->current_screen] = false;
+        ui->needs_full_redraw = false;
     } else if (screen->update) {
         screen->update(dc);
         HAL_DisplayUpdate();
     }
 }
 
+void UI_SwitchScreen(DiveComputer* dc, ScreenType screen) {
+    dc->ui.current_screen = screen;
+    dc->ui.needs_full_redraw = true;
+}
+
+void UI_ForceRedraw(DiveComputer* dc) {
+    dc->ui.needs_full_redraw = true;
+}
+
 void UI_DrawMainDiveScreen(DiveComputer* dc) {
     char buffer[32];
     
@@ -48,8 +54,15 @@ void UI_DrawMainDiveScreen(DiveComputer* dc) {
     // Temps de plongée
     UI_DrawTime(200, 20, dc->dive.current_dive.duration);
     
-    // NDL ou Déco
-    if (dc->zhl16.ceiling > 0) {
+    // NDL ou Déco (en surface : désaturation et interdiction de vol)
+    if (!dc->dive.is_diving && (dc->zhl16.desat_time > 0 || dc->zhl16.nofly_time > 0)) {
+        uint32_t desat = (uint32_t)dc->zhl16.desat_time;
+        uint32_t nofly = (uint32_t)dc->zhl16.nofly_time;
+        sprintf(buffer, "DESAT %luh%02lu", (unsigned long)(desat / 60), (unsigned long)(desat % 60));
+        UI_DrawText(10, 80, buffer, COLOR_WHITE, 2);
+        sprintf(buffer, "NO FLY %luh%02lu", (unsigned long)(nofly / 60), (unsigned long)(nofly % 60));
+        UI_DrawText(10, 110, buffer, nofly > 0 ? COLOR_YELLOW : COLOR_GREEN, 2);
+    } else if (dc->zhl16.ceiling > 0) {
         UI_DrawDeco(10, 80, dc->zhl16.ceiling, dc->zhl16.ascend_plan.tts);
     } else {
         UI_DrawNDL(10, 80, dc->zhl16.ndl);
@@ -81,9 +94,9 @@ void UI_DrawMainDiveScreen(DiveComputer* dc) {
     
     // Alarmes visuelles
     if (dc->dive.ascent_rate_alarm) {
-        UI_ShowAlarm("SLOW DOWN!", 2);
+        UI_ShowAlarm(dc, "SLOW DOWN!", 2);
     } else if (dc->dive.deco_ceiling_alarm) {
-        UI_ShowAlarm("DECO VIOLATION!", 3);
+        UI_ShowAlarm(dc, "DECO VIOLATION!", 3);
     }
 }
 
@@ -166,11 +179,99 @@ void UI_DrawDecoInfoScreen(DiveComputer* dc) {
         UI_DrawText(20, 200, buffer, COLOR_YELLOW, 2);
     }
     
+    // Scénarios what-if (à côté de la liste des paliers)
+    AscendPlan* what_if = dc->zhl16.what_if;
+    if (plan->num_stops > 0 && what_if[WHATIF_EXTRA_TIME].is_valid) {
+        sprintf(buffer, "@+5: %d min", what_if[WHATIF_EXTRA_TIME].tts);
+        UI_DrawText(200, 100, buffer, COLOR_GRAY, 1);
+    }
+    if (plan->num_stops > 0 && what_if[WHATIF_LOST_GAS].is_valid &&
+        dc->zhl16.what_if_lost_gas != ZHL16_NO_GAS) {
+        sprintf(buffer, "-%s: %d min", dc->zhl16.gases[dc->zhl16.what_if_lost_gas].name,
+                what_if[WHATIF_LOST_GAS].tts);
+        UI_DrawText(200, 120, buffer, COLOR_GRAY, 1);
+    }
+    if (plan->num_stops > 0 && what_if[WHATIF_BAILOUT].is_valid && dc->zhl16.ccr_mode) {
+        sprintf(buffer, "BO: %d min", what_if[WHATIF_BAILOUT].tts);
+        UI_DrawText(200, 140, buffer, COLOR_GRAY, 1);
+    }
+    
     // GF actuel
     sprintf(buffer, "GF: %.0f%%", dc->zhl16.gf_current);
     UI_DrawText(200, 200, buffer, COLOR_CYAN, 1);
 }
 
+// Liste des gaz : MOD et profondeur de passage (table de changement du modèle)
+void UI_DrawGasListScreen(DiveComputer* dc) {
+    char buffer[32];
+    
+    UI_DrawText(100, 10, "GAS LIST", COLOR_CYAN, 2);
+    UI_DrawText(20, 40, "Gas        MOD  Switch", COLOR_GRAY, 1);
+    
+    for (uint8_t i = 0; i < dc->zhl16.num_gases && i < 8; i++) {
+        GasMix* gas = &dc->zhl16.gases[i];
+        float switch_depth = ZHL16_GetSwitchDepth(&dc->zhl16, i);
+        uint16_t color = COLOR_WHITE;
+        
+        if (!gas->is_enabled) color = COLOR_GRAY;
+        else if (i == dc->zhl16.current_gas) color = COLOR_GREEN;
+        
+        if (switch_depth >= 0) {
+            sprintf(buffer, "%-9s %4.0fm %4.0fm", gas->name, gas->mod, switch_depth);
+        } else {
+            sprintf(buffer, "%-9s %4.0fm    -", gas->name, gas->mod);
+        }
+        UI_DrawText(20, 60 + i * 20, buffer, color, 1);
+    }
+}
+
+// Date civile (UTC) d'un horodatage Unix
+static void UI_FormatDate(uint32_t timestamp, char* buffer) {
+    int32_t days = (int32_t)(timestamp / 86400) + 719468;
+    int32_t era = days / 146097;
+    uint32_t doe = (uint32_t)(days - era * 146097);
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    uint32_t day = doy - (153 * mp + 2) / 5 + 1;
+    uint32_t month = mp < 10 ? mp + 3 : mp - 9;
+    uint32_t year = yoe + era * 400 + (month <= 2);
+    
+    sprintf(buffer, "%02u/%02u/%02u", (unsigned)day, (unsigned)month, (unsigned)(year % 100));
+}
+
+// Carnet : une page de résumés lue à chaque affichage, sans les profils
+void UI_DrawLogbook(DiveComputer* dc) {
+    DiveSummary entries[UI_LOGBOOK_ROWS];
+    char buffer[40];
+    char date[12];
+    uint32_t total = DiveManager_GetLogbookSize(&dc->dive);
+    uint16_t count = DiveManager_GetLogbookPage(&dc->dive, dc->ui.logbook_first, entries, UI_LOGBOOK_ROWS);
+    uint8_t row = 0;
+    
+    UI_DrawText(100, 10, "LOGBOOK", COLOR_CYAN, 2);
+    if (count == 0) {
+        UI_DrawText(100, 100, "NO DIVES", COLOR_GRAY, 2);
+        return;
+    }
+    UI_DrawText(20, 40, "  #    Date      Max   Time", COLOR_GRAY, 1);
+    
+    for (uint16_t i = 0; i < count; i++) {
+        DiveSummary* entry = &entries[i];
+        if (entry->dive_number == 0) continue;
+        
+        UI_FormatDate(entry->start_rtc, date);
+        sprintf(buffer, "%4u  %s %5.1fm %4u'", (unsigned)entry->dive_number, date, entry->max_depth / 100.0f,
+                (unsigned)(entry->duration / 60));
+        UI_DrawText(20, 60 + row * 20, buffer, entry->deco_violations ? COLOR_ORANGE : COLOR_WHITE, 1);
+        row++;
+    }
+    
+    sprintf(buffer, "%u-%u / %u", (unsigned)(dc->ui.logbook_first + 1),
+            (unsigned)(dc->ui.logbook_first + count), (unsigned)total);
+    UI_DrawText(200, 220, buffer, COLOR_GRAY, 1);
+}
+
 // Éléments d'interface
 void UI_DrawDepth(uint16_t x, uint16_t y, float depth, bool metric) {
     char buffer[16];
@@ -257,12 +358,12 @@ void UI_DrawRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t color)
     }
 }
 
-void UI_ShowAlarm(const char* message, uint8_t severity) {
+void UI_ShowAlarm(DiveComputer* dc, const char* message, uint8_t severity) {
     uint32_t now = HAL_GetSysTick();
     
     // Copier le message
-    strncpy(ui_state.alarm_message, message, sizeof(ui_state.alarm_message) - 1);
-    ui_state.last_alarm_time = now;
+    strncpy(dc->ui.alarm_message, message, sizeof(dc->ui.alarm_message) - 1);
+    dc->ui.last_alarm_time = now;
     
     // Flash écran selon sévérité
     if (severity >= 3) {
@@ -278,5 +379,10 @@ void UI_ShowAlarm(const char* message, uint8_t severity) {
     // Affichage du message
     uint16_t bg_color = (severity >= 3) ? COLOR_RED : COLOR_YELLOW;
     UI_DrawRect(40, 100, 240, 40, bg_color);
-    UI_DrawText(50, 110, ui_state.alarm_message, COLOR_WHITE, 2);
+    UI_DrawText(50, 110, dc->ui.alarm_message, COLOR_WHITE, 2);
+}
+
+void UI_ClearAlarm(DiveComputer* dc) {
+    dc->ui.alarm_message[0] = '\0';
+    dc->ui.needs_full_redraw = true;
 }
\ No newline at end of file
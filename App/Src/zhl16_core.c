@@ -1,45 +1,84 @@
 #include "zhl16_core.h"
+#include "zhl16_kernel.h"
+#include "zhl16_tox.h"
 #include <string.h>
 
-// Tables ZHL-16B
-const float ZHL16B_N2_halftimes[NUM_COMPARTMENTS] = {
-    4.0, 8.0, 12.5, 18.5, 27.0, 38.3, 54.3, 77.0,
-    109.0, 146.0, 187.0, 239.0, 305.0, 390.0, 498.0, 635.0
-};
+#define ZHL16_MAX_STOP_TIME 3600    // Secondes : sécurité, max ~1h par palier
+#define ZHL16_NDL_NEVER     1e9f    // Minutes : M-value de surface jamais atteinte
+#define ZHL16_NDL_MAX_ITER  12      // Itérations de Newton par compartiment
+#define ZHL16_NDL_TOL_MIN   0.01f   // Convergence de Newton (minutes)
+#define ZHL16_NDL_MIN_RATE  1e-5f   // bar/min : écart négligeable (contre-diffusion)
+#define ZHL16_NDL_SERIES_MAX 0.02f  // k·pas max pour exp(-k·t) par série (erreur < 3e-11)
 
-const float ZHL16B_He_halftimes[NUM_COMPARTMENTS] = {
-    1.51, 3.02, 4.72, 6.99, 10.21, 14.48, 20.53, 29.11,
-    41.20, 55.19, 70.69, 90.34, 115.29, 147.42, 188.24, 240.03
-};
+// exp(-x) et ln(x) scalaires : noyaux entiers en virgule fixe, libm sinon
+#ifdef ZHL16_FIXED_POINT
+#define ZHL16_EXP_NEG(x)    Q30_TO_FLOAT(Q30_ExpNeg((int64_t)((x) * 1073741824.0f)))
+#define ZHL16_LOG(x)        Q24_TO_FLOAT(Q24_Log(Q24_FROM_FLOAT(x)))
+#else
+#define ZHL16_EXP_NEG(x)    expf(-(x))
+#define ZHL16_LOG(x)        logf(x)
+#endif
 
-const float ZHL16B_N2_a[NUM_COMPARTMENTS] = {
-    1.2599, 1.0000, 0.8618, 0.7562, 0.6667, 0.5933,
-    0.5282, 0.4701, 0.4187, 0.3798, 0.3497, 0.3223,
-    0.2971, 0.2737, 0.2523, 0.2327
-};
+static void ZHL16_ComputeDecayFactors(const ZHL16Coefficients* coeffs, float time_seconds,
+                                      DecayFactors* decay);
+static uint8_t ZHL16_BestGasAt(const ZHL16Model* model, float depth, uint8_t fallback,
+                               uint16_t gas_mask);
 
-const float ZHL16B_N2_b[NUM_COMPARTMENTS] = {
-    0.5050, 0.6514, 0.7222, 0.7825, 0.8126, 0.8434,
-    0.8693, 0.8910, 0.9092, 0.9222, 0.9319, 0.9403,
-    0.9477, 0.9544, 0.9602, 0.9653
-};
+// Coefficients ZHL-16B/C générés à la compilation, une ligne par compartiment :
+//   X(demi-période N2, demi-période He, a N2 (B), a N2 (C), b N2, a He, b He)
+// Demi-périodes en minutes ; a/b He publiés, communs à B et C.
+#define ZHL16_COMPARTMENTS(X) \
+    X(4.0   , 1.51   , 1.2599 , 1.2599 , 0.5050 , 1.7424 , 0.4245) \
+    X(8.0   , 3.02   , 1.0000 , 1.0000 , 0.6514 , 1.3830 , 0.5747) \
+    X(12.5  , 4.72   , 0.8618 , 0.8618 , 0.7222 , 1.1919 , 0.6527) \
+    X(18.5  , 6.99   , 0.7562 , 0.7562 , 0.7825 , 1.0458 , 0.7223) \
+    X(27.0  , 10.21  , 0.6667 , 0.6200 , 0.8126 , 0.9220 , 0.7582) \
+    X(38.3  , 14.48  , 0.5933 , 0.5043 , 0.8434 , 0.8205 , 0.7957) \
+    X(54.3  , 20.53  , 0.5282 , 0.4410 , 0.8693 , 0.7305 , 0.8279) \
+    X(77.0  , 29.11  , 0.4701 , 0.4000 , 0.8910 , 0.6502 , 0.8553) \
+    X(109.0 , 41.20  , 0.4187 , 0.3750 , 0.9092 , 0.5950 , 0.8757) \
+    X(146.0 , 55.19  , 0.3798 , 0.3500 , 0.9222 , 0.5545 , 0.8903) \
+    X(187.0 , 70.69  , 0.3497 , 0.3295 , 0.9319 , 0.5333 , 0.8997) \
+    X(239.0 , 90.34  , 0.3223 , 0.3065 , 0.9403 , 0.5189 , 0.9073) \
+    X(305.0 , 115.29 , 0.2971 , 0.2835 , 0.9477 , 0.5181 , 0.9122) \
+    X(390.0 , 147.42 , 0.2737 , 0.2610 , 0.9544 , 0.5176 , 0.9171) \
+    X(498.0 , 188.24 , 0.2523 , 0.2480 , 0.9602 , 0.5172 , 0.9217) \
+    X(635.0 , 240.03 , 0.2327 , 0.2327 , 0.9653 , 0.5119 , 0.9267)
 
-// Tables ZHL-16C (plus conservatrices)
-const float ZHL16C_N2_halftimes[NUM_COMPARTMENTS] = {
-    4.0, 8.0, 12.5, 18.5, 27.0, 38.3, 54.3, 77.0,
-    109.0, 146.0, 187.0, 239.0, 305.0, 390.0, 498.0, 635.0
-};
+#define ZHL16_K(half_time)  ZHL16_FRACTION(0.69314718f / (half_time))
 
-const float ZHL16C_N2_a[NUM_COMPARTMENTS] = {
-    1.2599, 1.0000, 0.8618, 0.7562, 0.6200, 0.5043,
-    0.4410, 0.4000, 0.3750, 0.3500, 0.3295, 0.3065,
-    0.2835, 0.2610, 0.2480, 0.2327
+#define ZHL16_HT_N2(ht_N2, ht_He, a_B, a_C, b_N2, a_He, b_He)   ht_N2,
+#define ZHL16_HT_HE(ht_N2, ht_He, a_B, a_C, b_N2, a_He, b_He)   ht_He,
+#define ZHL16_K_N2(ht_N2, ht_He, a_B, a_C, b_N2, a_He, b_He)    ZHL16_K(ht_N2),
+#define ZHL16_K_HE(ht_N2, ht_He, a_B, a_C, b_N2, a_He, b_He)    ZHL16_K(ht_He),
+#define ZHL16_A_N2_B(ht_N2, ht_He, a_B, a_C, b_N2, a_He, b_He)  ZHL16_REAL(a_B),
+#define ZHL16_A_N2_C(ht_N2, ht_He, a_B, a_C, b_N2, a_He, b_He)  ZHL16_REAL(a_C),
+#define ZHL16_B_N2(ht_N2, ht_He, a_B, a_C, b_N2, a_He, b_He)    ZHL16_REAL(b_N2),
+#define ZHL16_A_HE(ht_N2, ht_He, a_B, a_C, b_N2, a_He, b_He)    ZHL16_REAL(a_He),
+#define ZHL16_B_HE(ht_N2, ht_He, a_B, a_C, b_N2, a_He, b_He)    ZHL16_REAL(b_He),
+
+// Tables ZHL-16B (en flash)
+const ZHL16Coefficients ZHL16B_Coefficients = {
+    .half_time_N2 = { ZHL16_COMPARTMENTS(ZHL16_HT_N2) },
+    .half_time_He = { ZHL16_COMPARTMENTS(ZHL16_HT_HE) },
+    .k_N2 = { ZHL16_COMPARTMENTS(ZHL16_K_N2) },
+    .k_He = { ZHL16_COMPARTMENTS(ZHL16_K_HE) },
+    .a_N2 = { ZHL16_COMPARTMENTS(ZHL16_A_N2_B) },
+    .b_N2 = { ZHL16_COMPARTMENTS(ZHL16_B_N2) },
+    .a_He = { ZHL16_COMPARTMENTS(ZHL16_A_HE) },
+    .b_He = { ZHL16_COMPARTMENTS(ZHL16_B_HE) }
 };
 
-const float ZHL16C_N2_b[NUM_COMPARTMENTS] = {
-    0.5050, 0.6514, 0.7222, 0.7825, 0.8126, 0.8434,
-    0.8693, 0.8910, 0.9092, 0.9222, 0.9319, 0.9403,
-    0.9477, 0.9544, 0.9602, 0.9653
+// Tables ZHL-16C (plus conservatrices)
+const ZHL16Coefficients ZHL16C_Coefficients = {
+    .half_time_N2 = { ZHL16_COMPARTMENTS(ZHL16_HT_N2) },
+    .half_time_He = { ZHL16_COMPARTMENTS(ZHL16_HT_HE) },
+    .k_N2 = { ZHL16_COMPARTMENTS(ZHL16_K_N2) },
+    .k_He = { ZHL16_COMPARTMENTS(ZHL16_K_HE) },
+    .a_N2 = { ZHL16_COMPARTMENTS(ZHL16_A_N2_C) },
+    .b_N2 = { ZHL16_COMPARTMENTS(ZHL16_B_N2) },
+    .a_He = { ZHL16_COMPARTMENTS(ZHL16_A_HE) },
+    .b_He = { ZHL16_COMPARTMENTS(ZHL16_B_HE) }
 };
 
 // Initialisation du modèle
@@ -49,6 +88,8 @@ void ZHL16_Init(ZHL16Model* model, float surface_pressure, bool use_zhl16c) {
     model->surface_pressure = surface_pressure;
     model->water_vapor_pressure = 0.0627; // bar à 37°C
     model->ambient_pressure = surface_pressure;
+    model->tissue_ambient_pressure = surface_pressure;
+    ZHL16_BuildGasSchedule(model);
     
     // Configuration par défaut
     model->config.gf_low = 30.0;
@@ -60,254 +101,1141 @@ void ZHL16_Init(ZHL16Model* model, float surface_pressure, bool use_zhl16c) {
     model->config.safety_stop_depth = 5.0;
     model->config.safety_stop_time = 180; // 3 minutes
     
-    // Initialisation des compartiments
+    // Saturation initiale avec air, puis coefficients du modèle
+    float air_pressure = (surface_pressure - model->water_vapor_pressure) * 0.79;
     for (int i = 0; i < NUM_COMPARTMENTS; i++) {
-        Compartment* comp = &model->compartments[i];
-        
-        if (use_zhl16c) {
-            comp->half_time_N2 = ZHL16C_N2_halftimes[i];
-            comp->a_N2 = ZHL16C_N2_a[i];
-            comp->b_N2 = ZHL16C_N2_b[i];
-        } else {
-            comp->half_time_N2 = ZHL16B_N2_halftimes[i];
-            comp->a_N2 = ZHL16B_N2_a[i];
-            comp->b_N2 = ZHL16B_N2_b[i];
-        }
-        
-        comp->half_time_He = ZHL16B_He_halftimes[i];
-        comp->a_He = comp->a_N2 * 1.5;
-        comp->b_He = comp->b_N2 * 0.9;
-        
-        // Saturation initiale avec air
-        float air_pressure = (surface_pressure - model->water_vapor_pressure) * 0.79;
-        comp->pressure_N2 = air_pressure;
-        comp->pressure_He = 0.0;
-        comp->loading = 0.0;
+        model->tissues.pressure_N2[i] = ZHL16_PRESSURE(air_pressure);
+        model->tissues.pressure_He[i] = ZHL16_PRESSURE(0.0);
+        model->tissues.loading[i] = ZHL16_REAL(0.0);
     }
+    
+    ZHL16_SetModel(model, use_zhl16c);
 }
 
-// Mise à jour des tissus
-void ZHL16_UpdateTissues(ZHL16Model* model, float time_seconds) {
-    float time_minutes = time_seconds / 60.0;
-    GasMix* gas = &model->gases[model->current_gas];
+// Sélection des coefficients ZHL-16B/C : simple pointeur vers la table en
+// flash (invalide les caches de décroissance, de NDL et de plafond, recalcule
+// les a/b pondérés des tissus)
+void ZHL16_SetModel(ZHL16Model* model, bool use_zhl16c) {
+    model->coeffs = use_zhl16c ? &ZHL16C_Coefficients : &ZHL16B_Coefficients;
+    
+    ZHL16_InvalidateDecayCache(model);
+    ZHL16K_UpdateMix(&model->tissues, model->coeffs);
+    model->ndl_cache.valid = false;
+    model->ceiling_state.valid = false;
+}
+
+// Début de plongée : efface l'état propre à la plongée précédente (profondeur
+// maximale, temps, ancre des gradient factors, caches NDL et plafond, plans
+// publiés). Tissus, CNS et OTU sont conservés (plongées successives).
+void ZHL16_BeginDive(ZHL16Model* model) {
+    model->repetitive_dive = model->desat_time > 0 || model->nofly_minimum > 0;
+    model->max_depth = model->current_depth;
+    model->average_depth = 0;
+    model->dive_time_seconds = 0;
+    model->ceiling = 0;
+    model->ndl = 0;
+    memset(&model->ascend_plan, 0, sizeof(AscendPlan));
+    memset(model->what_if, 0, sizeof(model->what_if));
+    model->what_if_lost_gas = ZHL16_NO_GAS;
+    memset(&model->plan_inputs, 0, sizeof(ZHL16PlanInputs));
+    memset(&model->ndl_cache, 0, sizeof(ZHL16NDLCache));
+    memset(&model->ceiling_state, 0, sizeof(ZHL16CeilingState));
+}
+
+// Fin de plongée : plans publiés effacés (TTS nul en surface), interdiction
+// de vol minimale comptée dès la sortie, 24 h si des paliers ont été
+// obligatoires (ancre des GF posée), 18 h après une plongée successive, 12 h
+// sinon ; jamais raccourcie par une plongée plus courte
+void ZHL16_EndDive(ZHL16Model* model) {
+    float minimum = NOFLY_MIN_SINGLE_MIN;
     
-    // Variables pour tracking
-    float max_loading = 0.0;
-    model->leading_compartment = 0;
+    memset(&model->ascend_plan, 0, sizeof(AscendPlan));
+    memset(model->what_if, 0, sizeof(model->what_if));
+    model->what_if_lost_gas = ZHL16_NO_GAS;
+    model->plan_inputs.valid = false;
     
+    if (model->ceiling_state.anchor_depth > 0) {
+        minimum = NOFLY_MIN_DECO_MIN;
+    } else if (model->repetitive_dive) {
+        minimum = NOFLY_MIN_REPETITIVE_MIN;
+    }
+    if (minimum > model->nofly_minimum) {
+        model->nofly_minimum = minimum;
+    }
+}
+
+// Vide le cache des facteurs (à appeler si la table de coefficients change)
+void ZHL16_InvalidateDecayCache(ZHL16Model* model) {
+    for (int j = 0; j < ZHL16_DECAY_CACHE_SIZE; j++) {
+        model->decay_cache[j].valid = false;
+        model->decay_cache[j].last_use = 0;
+    }
+    model->decay_cache_clock = 0;
+}
+
+// Facteurs exp(-k*t) pour un pas de temps : recherche dans le cache, sinon
+// recalcul dans l'entrée la moins récemment utilisée (32 expf par échec)
+const DecayFactors* ZHL16_GetDecayFactors(ZHL16Model* model, float time_seconds) {
+    DecayFactors* victim = &model->decay_cache[0];
+    model->decay_cache_clock++;
+    
+    for (int j = 0; j < ZHL16_DECAY_CACHE_SIZE; j++) {
+        DecayFactors* entry = &model->decay_cache[j];
+        if (entry->valid && entry->time_seconds == time_seconds) {
+            entry->last_use = model->decay_cache_clock;
+            return entry;
+        }
+        if (victim->valid && (!entry->valid || entry->last_use < victim->last_use)) {
+            victim = entry;
+        }
+    }
+    
+    ZHL16_ComputeDecayFactors(model->coeffs, time_seconds, victim);
+    victim->last_use = model->decay_cache_clock;
+    victim->valid = true;
+    
+    return victim;
+}
+
+// Facteurs exp(-k*t) hors cache (durées uniques : paliers et remontées du
+// planificateur, reliquats de mise à jour des tissus)
+static void ZHL16_ComputeDecayFactors(const ZHL16Coefficients* coeffs, float time_seconds,
+                                      DecayFactors* decay) {
+#ifdef ZHL16_FIXED_POINT
+    // k (Q2.30, min^-1) * t (Q16.16, s) / 60 : exposant Q2.30 sur 64 bits
+    // (t sur 64 bits : jusqu'à SURFACE_MAX_STEP_S sans débordement)
+    int64_t time_q16 = (int64_t)(time_seconds * 65536.0f);
     for (int i = 0; i < NUM_COMPARTMENTS; i++) {
-        Compartment* comp = &model->compartments[i];
-        
-        // Calcul des pressions inspirées
-        float inspired_N2, inspired_He;
+        decay->factor_N2[i] = Q30_ExpNeg(coeffs->k_N2[i] * time_q16 / (60 << 16));
+        decay->factor_He[i] = Q30_ExpNeg(coeffs->k_He[i] * time_q16 / (60 << 16));
+    }
+#else
+    float time_minutes = time_seconds / 60.0;
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        decay->factor_N2[i] = expf(-coeffs->k_N2[i] * time_minutes);
+        decay->factor_He[i] = expf(-coeffs->k_He[i] * time_minutes);
+    }
+#endif
+    decay->time_seconds = time_seconds;
+}
+
+// Pressions inspirées N2/He pour un gaz et un mode donnés à une pression ambiante
+static void ZHL16_InspiredPressures(const ZHL16Model* model, uint8_t gas_idx, bool ccr_mode,
+                                    float ppO2, float ambient_pressure,
+                                    float* inspired_N2, float* inspired_He) {
+    const GasMix* gas = &model->gases[gas_idx];
+    
+    if (ccr_mode) {
+        // Mode CCR : utilise la ppO2 mesurée
+        float diluent_pressure = ambient_pressure - ppO2;
+        float total_inert = gas->fN2 + gas->fHe;
         
-        if (model->ccr_mode) {
-            // Mode CCR : utilise la ppO2 mesurée
-            float diluent_pressure = model->ambient_pressure - model->actual_ppO2;
-            float total_inert = gas->fN2 + gas->fHe;
-            
-            if (total_inert > 0) {
-                inspired_N2 = diluent_pressure * (gas->fN2 / total_inert);
-                inspired_He = diluent_pressure * (gas->fHe / total_inert);
-            } else {
-                inspired_N2 = 0;
-                inspired_He = 0;
-            }
+        if (total_inert > 0) {
+            *inspired_N2 = diluent_pressure * (gas->fN2 / total_inert);
+            *inspired_He = diluent_pressure * (gas->fHe / total_inert);
         } else {
-            // Circuit ouvert
-            inspired_N2 = (model->ambient_pressure - model->water_vapor_pressure) * gas->fN2;
-            inspired_He = (model->ambient_pressure - model->water_vapor_pressure) * gas->fHe;
-        }
-        
-        // Équation de Schreiner
-        float k_N2 = 0.693147 / comp->half_time_N2;
-        float k_He = 0.693147 / comp->half_time_He;
-        
-        comp->pressure_N2 = inspired_N2 + (comp->pressure_N2 - inspired_N2) * expf(-k_N2 * time_minutes);
-        comp->pressure_He = inspired_He + (comp->pressure_He - inspired_He) * expf(-k_He * time_minutes);
-        
-        // Calcul du pourcentage de saturation
-        float p_total = comp->pressure_N2 + comp->pressure_He;
-        float a = (comp->a_N2 * comp->pressure_N2 + comp->a_He * comp->pressure_He) / p_total;
-        float b = (comp->b_N2 * comp->pressure_N2 + comp->b_He * comp->pressure_He) / p_total;
-        
-        float m_value = a + model->ambient_pressure / b;
-        comp->loading = (p_total / m_value) * 100.0;
-        
-        if (comp->loading > max_loading) {
-            max_loading = comp->loading;
-            model->leading_compartment = i;
+            *inspired_N2 = 0;
+            *inspired_He = 0;
         }
+    } else {
+        // Circuit ouvert
+        *inspired_N2 = (ambient_pressure - model->water_vapor_pressure) * gas->fN2;
+        *inspired_He = (ambient_pressure - model->water_vapor_pressure) * gas->fHe;
     }
+}
+
+// Pressions inspirées pour le gaz et le mode courants du modèle
+static void ZHL16_GetInspiredPressures(const ZHL16Model* model, float ambient_pressure,
+                                       float* inspired_N2, float* inspired_He) {
+    ZHL16_InspiredPressures(model, model->current_gas, model->ccr_mode, model->actual_ppO2,
+                            ambient_pressure, inspired_N2, inspired_He);
+}
+
+// Pressions inspirées pour le gaz et le mode d'un état de simulation
+static void ZHL16_GetSimInspiredPressures(const ZHL16Model* model, const ZHL16PlannerState* sim,
+                                          float ambient_pressure,
+                                          float* inspired_N2, float* inspired_He) {
+    ZHL16_InspiredPressures(model, sim->current_gas, sim->ccr_mode, sim->actual_ppO2,
+                            ambient_pressure, inspired_N2, inspired_He);
+}
+
+// Intégration de Schreiner sur une rampe de pression inspirée (durée des facteurs)
+static void ZHL16_IntegrateLinear(const ZHL16Model* model, TissueState* tissues, const DecayFactors* decay,
+                                  float start_N2, float start_He, float end_N2, float end_He) {
+    float time_minutes = decay->time_seconds / 60.0;
+    ZHL16K_UpdateTissuesLinear(tissues, decay, model->coeffs, start_N2, start_He,
+                               (end_N2 - start_N2) / time_minutes,
+                               (end_He - start_He) / time_minutes);
+    ZHL16K_UpdateMix(tissues, model->coeffs);
+}
+
+// Avance les tissus à pression ambiante constante avec des facteurs donnés
+static void ZHL16_AdvanceTissues(ZHL16Model* model, const DecayFactors* decay, float time_seconds) {
+    float inspired_N2, inspired_He;
+    ZHL16_GetInspiredPressures(model, model->ambient_pressure, &inspired_N2, &inspired_He);
     
-    model->saturation_percent = max_loading;
+    // Équation de Schreiner, a/b pondérés puis saturation, noyaux 16 voies
+    ZHL16K_UpdateTissues(&model->tissues, decay, inspired_N2, inspired_He);
+    ZHL16K_UpdateMix(&model->tissues, model->coeffs);
+    model->saturation_percent = ZHL16K_UpdateLoading(&model->tissues, model->ambient_pressure,
+                                                     &model->leading_compartment);
+    model->tissue_ambient_pressure = model->ambient_pressure;
     model->dive_time_seconds += time_seconds;
+    model->ceiling_state.valid = false;
+}
+
+// Mise à jour des tissus
+void ZHL16_UpdateTissues(ZHL16Model* model, float time_seconds) {
+    ZHL16_AdvanceTissues(model, ZHL16_GetDecayFactors(model, time_seconds), time_seconds);
 }
 
-// Calcul du plafond
+// Gradient factor en % à une profondeur : GF bas au premier palier (ancre) et
+// au-delà, GF haut en surface, interpolation linéaire entre les deux
+static float ZHL16_GradientFactorAt(const DecoConfig* config, float anchor_depth, float depth) {
+    if (anchor_depth <= 0 || depth <= 0) {
+        return config->gf_high;
+    }
+    if (depth >= anchor_depth) {
+        return config->gf_low;
+    }
+    
+    return config->gf_high + (config->gf_low - config->gf_high) * depth / anchor_depth;
+}
+
+// Gradient factor actuel en % (constant sur les 16 compartiments)
+static float ZHL16_GetGradientFactor(const ZHL16Model* model) {
+    return ZHL16_GradientFactorAt(&model->config, model->ceiling_state.anchor_depth,
+                                  model->current_depth);
+}
+
+// Avance les tissus sur une variation linéaire de pression ambiante avec des facteurs donnés
+static void ZHL16_AdvanceTissuesLinear(ZHL16Model* model, float start_ambient, float end_ambient,
+                                       const DecayFactors* decay) {
+    float start_N2, start_He, end_N2, end_He;
+    ZHL16_GetInspiredPressures(model, start_ambient, &start_N2, &start_He);
+    ZHL16_GetInspiredPressures(model, end_ambient, &end_N2, &end_He);
+    
+    ZHL16_IntegrateLinear(model, &model->tissues, decay, start_N2, start_He, end_N2, end_He);
+    model->saturation_percent = ZHL16K_UpdateLoading(&model->tissues, end_ambient,
+                                                     &model->leading_compartment);
+    model->tissue_ambient_pressure = end_ambient;
+    model->dive_time_seconds += decay->time_seconds;
+    model->ceiling_state.valid = false;
+}
+
+// Mise à jour des tissus sur une variation linéaire de pression ambiante
+// (remontée, descente) : équation de Schreiner exacte en un seul pas.
+// Pas récurrents : facteurs pris dans le cache
+void ZHL16_UpdateTissuesLinear(ZHL16Model* model, float start_ambient, float end_ambient,
+                               float time_seconds) {
+    if (time_seconds <= 0) return;
+    
+    ZHL16_AdvanceTissuesLinear(model, start_ambient, end_ambient,
+                               ZHL16_GetDecayFactors(model, time_seconds));
+}
+
+// Idem pour une durée ponctuelle (reliquat avant un changement de gaz, fin de
+// plongée...) : facteurs calculés hors cache, sans évincer les pas récurrents
+void ZHL16_UpdateTissuesLinearOnce(ZHL16Model* model, float start_ambient, float end_ambient,
+                                   float time_seconds) {
+    DecayFactors decay;
+    if (time_seconds <= 0) return;
+    
+    ZHL16_ComputeDecayFactors(model->coeffs, time_seconds, &decay);
+    ZHL16_AdvanceTissuesLinear(model, start_ambient, end_ambient, &decay);
+}
+
+// Mise à jour de la profondeur (les tissus sont intégrés à part)
+void ZHL16_UpdateDepth(ZHL16Model* model, float depth_meters) {
+    model->current_depth = depth_meters;
+    if (depth_meters > model->max_depth) {
+        model->max_depth = depth_meters;
+    }
+    model->ambient_pressure = ZHL16_GetAmbientPressure(depth_meters, model->surface_pressure);
+    model->ceiling_state.valid = false;
+}
+
+// Plafond (m, arrondi au palier supérieur) d'une pression ambiante tolérée
+static float ZHL16_CeilingDepth(const ZHL16Model* model, float p_tolerated) {
+    float ceiling = (p_tolerated - model->surface_pressure) * 10.0;
+    if (ceiling < 0) {
+        ceiling = 0.0;
+    }
+    
+    // Arrondir au palier supérieur
+    if (ceiling > 0) {
+        ceiling = ceilf(ceiling / model->config.last_stop_depth) * model->config.last_stop_depth;
+    }
+    
+    return ceiling;
+}
+
+// Plafond d'un état tissulaire pour un GF en fraction (a/b pondérés à jour)
+static float ZHL16_CeilingFromTissues(const ZHL16Model* model, const TissueState* tissues, float gf) {
+    return ZHL16_CeilingDepth(model, ZHL16K_MaxToleratedPressure(tissues, gf));
+}
+
+// Palier le moins profond permis par la droite des GF, règle de
+// ZHL16_PlannerStep : depuis le premier palier au GF bas, on remonte d'un
+// palier tant que le plafond au GF de la profondeur visée n'y dépasse pas
+static float ZHL16_StopCeiling(const ZHL16Model* model, float tolerated_low) {
+    const DecoConfig* config = &model->config;
+    float anchor = model->ceiling_state.anchor_depth;
+    float stop = ZHL16_CeilingDepth(model, tolerated_low);
+    
+    while (stop > 0) {
+        float next = stop - config->last_stop_depth;
+        if (next < 0) next = 0;
+        float gf = ZHL16_GradientFactorAt(config, anchor, next) / 100.0f;
+        if (ZHL16_CeilingFromTissues(model, &model->tissues, gf) > next) break;
+        stop = next;
+    }
+    return stop;
+}
+
+// Calcul du plafond : une passe sur les a/b pondérés mémorisés avec les tissus
+// donne aussi le premier palier au GF bas (ancre de la droite des GF), le GF99
+// et le GF de surface. Une fois l'ancre posée, le plafond affiché suit la même
+// règle que le planificateur (ZHL16_StopCeiling) : un plongeur qui suit le plan
+// ne le franchit pas. Réutilisé tant que tissus, profondeur et GF ne changent pas.
 float ZHL16_GetCeiling(ZHL16Model* model) {
-    float ceiling = 0.0;
+    ZHL16CeilingState* st = &model->ceiling_state;
+    float gf = ZHL16_GetGradientFactor(model) / 100.0f;
+    float gf_low = model->config.gf_low / 100.0f;
     
-    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
-        Compartment* comp = &model->compartments[i];
-        
-        float p_total = comp->pressure_N2 + comp->pressure_He;
-        if (p_total <= 0) continue;
+    if (st->valid && st->gf == gf && st->gf_low == gf_low) {
+        return model->ceiling;
+    }
+    
+    ZHL16KCeiling pass;
+    ZHL16K_CeilingPass(&model->tissues, gf, gf_low, model->ambient_pressure,
+                       model->surface_pressure, &pass);
+    
+    // Dès l'obligation de palier (plafond au GF haut), la droite des GF s'ancre
+    // au premier palier au GF bas ; l'ancre ne fait ensuite que descendre
+    float first_stop = ZHL16_CeilingDepth(model, pass.tolerated_low);
+    if (first_stop > st->anchor_depth &&
+        (st->anchor_depth > 0 || ZHL16_CeilingDepth(model, pass.tolerated) > 0)) {
+        st->anchor_depth = first_stop;
+        float anchored = ZHL16_GetGradientFactor(model) / 100.0f;
+        if (anchored == gf_low) {
+            pass.tolerated = pass.tolerated_low;
+        } else if (anchored != gf) {
+            pass.tolerated = ZHL16K_MaxToleratedPressure(&model->tissues, anchored);
+        }
+        gf = anchored;
+    }
+    
+    if (st->anchor_depth > 0) {
+        model->ceiling = ZHL16_StopCeiling(model, pass.tolerated_low);
+    } else {
+        model->ceiling = ZHL16_CeilingDepth(model, pass.tolerated);
+    }
+    model->gf_current = pass.gf99;
+    model->gf_surface = pass.gf_surface;
+    st->gf = gf;
+    st->gf_low = gf_low;
+    st->valid = true;
+    
+    return model->ceiling;
+}
+
+// Palier obligatoire ?
+bool ZHL16_NeedsDecoStop(ZHL16Model* model) {
+    return ZHL16_GetCeiling(model) > 0;
+}
+
+// Pression ambiante tolérée par un compartiment (a et b pondérés N2/He)
+static float ZHL16_ToleratedPressure(const ZHL16Coefficients* c, int i,
+                                     float p_N2, float p_He, float gf) {
+    float p_total = p_N2 + p_He;
+    float a = (ZHL16_REAL_F(c->a_N2[i]) * p_N2 + ZHL16_REAL_F(c->a_He[i]) * p_He) / p_total;
+    float b = (ZHL16_REAL_F(c->b_N2[i]) * p_N2 + ZHL16_REAL_F(c->b_He[i]) * p_He) / p_total;
+    return (p_total - a * gf) / (gf / b - gf + 1.0);
+}
+
+// Le compartiment i tolère-t-il p_next après "minutes" à pression constante ?
+static bool ZHL16_StopClearedAfter(const ZHL16Coefficients* c, int i, float p_N2, float p_He,
+                                   float inspired_N2, float inspired_He, float gf,
+                                   float p_next, uint16_t minutes) {
+    float p_N2_t = inspired_N2 + (p_N2 - inspired_N2) * ZHL16_EXP_NEG(ZHL16_FRACTION_F(c->k_N2[i]) * minutes);
+    float p_He_t = inspired_He + (p_He - inspired_He) * ZHL16_EXP_NEG(ZHL16_FRACTION_F(c->k_He[i]) * minutes);
+    return ZHL16_ToleratedPressure(c, i, p_N2_t, p_He_t, gf) <= p_next;
+}
+
+// Minutes entières de palier (profondeur constante) avant que tous les
+// compartiments tolèrent la pression du palier suivant. N2 seul : inversion
+// logarithmique de Schreiner ; N2 + He (a/b variables) : dichotomie ou balayage
+// du compartiment. Retourne max_minutes si le palier ne se libère pas avant.
+static uint16_t ZHL16_SolveStopMinutes(const ZHL16Model* model, const ZHL16PlannerState* sim,
+                                       float next_depth, uint16_t max_minutes) {
+    const ZHL16Coefficients* c = model->coeffs;
+    const TissueState* t = &sim->tissues;
+    float gf = sim->gf;
+    float p_next = model->surface_pressure + next_depth / 10.0;
+    float inspired_N2, inspired_He;
+    uint16_t minutes = 0;
+    
+    ZHL16_GetSimInspiredPressures(model, sim, sim->ambient_pressure, &inspired_N2, &inspired_He);
+    
+    for (int i = 0; i < NUM_COMPARTMENTS && minutes < max_minutes; i++) {
+        float p_N2 = ZHL16_PRESSURE_F(t->pressure_N2[i]);
+        float p_He = ZHL16_PRESSURE_F(t->pressure_He[i]);
+        if (p_N2 + p_He <= 0 || ZHL16_ToleratedPressure(c, i, p_N2, p_He, gf) <= p_next) {
+            continue;
+        }
         
-        // Coefficients moyens pondérés
-        float a = (comp->a_N2 * comp->pressure_N2 + comp->a_He * comp->pressure_He) / p_total;
-        float b = (comp->b_N2 * comp->pressure_N2 + comp->b_He * comp->pressure_He) / p_total;
+        uint16_t needed = max_minutes;
         
-        // Gradient factor actuel
-        float gf;
-        if (model->current_depth <= 0) {
-            gf = model->config.gf_high;
+        if (p_He <= 0 && inspired_He <= 0) {
+            // a et b constants : p_N2(t) <= p_limit
+            float p_limit = p_next * (gf / ZHL16_REAL_F(c->b_N2[i]) - gf + 1.0) + ZHL16_REAL_F(c->a_N2[i]) * gf;
+            if (inspired_N2 < p_limit) {
+                float t_min = -ZHL16_LOG((p_limit - inspired_N2) / (p_N2 - inspired_N2)) /
+                              ZHL16_FRACTION_F(c->k_N2[i]);
+                if (t_min < max_minutes) {
+                    needed = (uint16_t)ceilf(t_min);
+                }
+            }
+        } else if ((p_N2 - inspired_N2) * (p_He - inspired_He) >= 0) {
+            // N2 et He évoluent dans le même sens : pression tolérée monotone,
+            // dichotomie sur les minutes dans ]lo, hi]
+            if (ZHL16_StopClearedAfter(c, i, p_N2, p_He, inspired_N2, inspired_He, gf, p_next, max_minutes)) {
+                uint16_t lo = 0;
+                uint16_t hi = max_minutes;
+                while (hi - lo > 1) {
+                    uint16_t mid = (lo + hi) / 2;
+                    if (ZHL16_StopClearedAfter(c, i, p_N2, p_He, inspired_N2, inspired_He, gf, p_next, mid)) {
+                        hi = mid;
+                    } else {
+                        lo = mid;
+                    }
+                }
+                needed = hi;
+            }
         } else {
-            float gf_slope = (model->config.gf_high - model->config.gf_low) / model->max_depth;
-            gf = model->config.gf_low + gf_slope * (model->max_depth - model->current_depth);
+            // Sens opposés (contre-diffusion) : trajectoire non monotone,
+            // balayage minute par minute du seul compartiment (multiplication-addition)
+            float decay_N2 = ZHL16_EXP_NEG(ZHL16_FRACTION_F(c->k_N2[i]));
+            float decay_He = ZHL16_EXP_NEG(ZHL16_FRACTION_F(c->k_He[i]));
+            for (uint16_t m = 1; m < max_minutes; m++) {
+                p_N2 = inspired_N2 + (p_N2 - inspired_N2) * decay_N2;
+                p_He = inspired_He + (p_He - inspired_He) * decay_He;
+                if (ZHL16_ToleratedPressure(c, i, p_N2, p_He, gf) <= p_next) {
+                    needed = m;
+                    break;
+                }
+            }
         }
         
-        // Pression ambiante tolérée avec GF
-        float p_tolerated = (p_total - a * (gf / 100.0)) / (1.0 / b - (gf / 100.0) + 1.0);
-        
-        // Conversion en profondeur
-        float comp_ceiling = (p_tolerated - model->surface_pressure) * 10.0;
-        
-        if (comp_ceiling > ceiling) {
-            ceiling = comp_ceiling;
+        if (needed > minutes) {
+            minutes = needed;
         }
     }
     
-    // Arrondir au palier supérieur
-    if (ceiling > 0) {
-        ceiling = ceilf(ceiling / model->config.last_stop_depth) * model->config.last_stop_depth;
+    return minutes;
+}
+
+// État de simulation : palier à pression constante (facteurs donnés)
+static void ZHL16_SimHold(ZHL16Model* model, ZHL16PlannerState* sim, const DecayFactors* decay) {
+    float inspired_N2, inspired_He;
+    ZHL16_GetSimInspiredPressures(model, sim, sim->ambient_pressure, &inspired_N2, &inspired_He);
+    ZHL16K_UpdateTissues(&sim->tissues, decay, inspired_N2, inspired_He);
+    ZHL16K_UpdateMix(&sim->tissues, model->coeffs);
+}
+
+// État de simulation : déplacement linéaire jusqu'à end_ambient (durée des facteurs)
+static void ZHL16_SimMove(ZHL16Model* model, ZHL16PlannerState* sim, float end_ambient,
+                          const DecayFactors* decay) {
+    if (decay->time_seconds > 0) {
+        float start_N2, start_He, end_N2, end_He;
+        ZHL16_GetSimInspiredPressures(model, sim, sim->ambient_pressure, &start_N2, &start_He);
+        ZHL16_GetSimInspiredPressures(model, sim, end_ambient, &end_N2, &end_He);
+        ZHL16_IntegrateLinear(model, &sim->tissues, decay, start_N2, start_He, end_N2, end_He);
     }
+    sim->ambient_pressure = end_ambient;
+}
+
+// Profondeur quantifiée pour la détection de changement
+static int16_t ZHL16_PlanDepthStep(float depth) {
+    return (int16_t)floorf(depth / PLAN_DEPTH_QUANTUM_M);
+}
+
+// Mémorise les entrées d'un calcul complet (au moment de l'instantané)
+static void ZHL16_RecordPlanInputs(ZHL16Model* model) {
+    ZHL16PlanInputs* in = &model->plan_inputs;
     
-    model->ceiling = ceiling;
-    return ceiling;
+    in->depth_step = ZHL16_PlanDepthStep(model->current_depth);
+    in->gas = model->current_gas;
+    in->ccr_mode = model->ccr_mode;
+    in->ppO2 = model->actual_ppO2;
+    in->gf_low = model->config.gf_low;
+    in->gf_high = model->config.gf_high;
+    in->computed_at = model->dive_time_seconds;
+    in->advanced_at = model->dive_time_seconds;
+    in->stop_elapsed = 0;
+    in->valid = true;
+    model->plan_full_count++;
 }
 
-// Calcul du plan de remontée
-void ZHL16_CalculateAscendPlan(ZHL16Model* model) {
+// Le plan publié correspond-il encore aux entrées ? Au palier, le temps écoulé
+// est décompté du premier palier et du TTS. Retourne false si un seuil est
+// franchi : un recalcul complet est alors nécessaire.
+bool ZHL16_PlanIsCurrent(ZHL16Model* model) {
+    ZHL16PlanInputs* in = &model->plan_inputs;
     AscendPlan* plan = &model->ascend_plan;
-    memset(plan, 0, sizeof(AscendPlan));
+    
+    if (!in->valid || !plan->is_valid) return false;
+    
+    // Changement d'entrée
+    if (ZHL16_PlanDepthStep(model->current_depth) != in->depth_step ||
+        model->current_gas != in->gas ||
+        model->ccr_mode != in->ccr_mode ||
+        fabsf(model->actual_ppO2 - in->ppO2) > PLAN_PPO2_TOLERANCE_BAR ||
+        model->config.gf_low != in->gf_low ||
+        model->config.gf_high != in->gf_high) {
+        return false;
+    }
+    
+    // Âge du plan : au palier la simulation suit la plongée réelle, ailleurs non
+    bool at_stop = plan->num_stops > 0 &&
+                   fabsf(model->current_depth - plan->stops[0].depth) < PLAN_DEPTH_QUANTUM_M;
+    uint32_t age = model->dive_time_seconds - in->computed_at;
+    if (age > (at_stop ? PLAN_MAX_AGE_S : PLAN_MAX_AGE_MOVING_S)) return false;
+    
+    // Avance du plan au palier
+    uint32_t elapsed = model->dive_time_seconds - in->advanced_at;
+    if (at_stop && elapsed > 0) {
+        if (elapsed >= plan->stops[0].time) return false;   // Palier terminé
+        
+        plan->stops[0].time -= elapsed;
+        in->stop_elapsed += elapsed;
+        while (in->stop_elapsed >= 60 && plan->tts > 0) {
+            plan->tts--;
+            in->stop_elapsed -= 60;
+        }
+    }
+    in->advanced_at = model->dive_time_seconds;
+    
+    model->plan_reuse_count++;
+    return true;
+}
+
+// Force un recalcul complet au prochain plan (changement de gaz disponibles...)
+void ZHL16_InvalidatePlan(ZHL16Model* model) {
+    model->plan_inputs.valid = false;
+}
+
+// Calcul du plan de remontée (synchrone : toutes les étapes d'un coup dans
+// la zone de travail de l'appelant), sauf si le plan publié est encore valable
+void ZHL16_CalculateAscendPlan(ZHL16PlannerJob* job, ZHL16Model* model) {
+    if (ZHL16_PlanIsCurrent(model)) return;
+    
+    ZHL16_PlannerBegin(job, model);
+    while (!ZHL16_PlannerStep(job, model)) {
+    }
+    ZHL16_PlannerPublish(job, model);
+}
+
+// Instantané compact du modèle pour la simulation (plafond à jour : ancre des GF)
+static void ZHL16_TakeSnapshot(ZHL16Model* model, ZHL16PlannerState* sim) {
+    ZHL16_GetCeiling(model);
+    sim->tissues = model->tissues;
+    sim->ambient_pressure = model->ambient_pressure;
+    sim->actual_ppO2 = model->actual_ppO2;
+    sim->gf = ZHL16_GetGradientFactor(model) / 100.0;
+    sim->gf_anchor = model->ceiling_state.anchor_depth;
+    sim->gas_mask = ZHL16_ALL_GASES;
+    sim->current_gas = model->current_gas;
+    sim->ccr_mode = model->ccr_mode;
+}
+
+// Remet un calcul au début (remontée vers le premier palier) depuis job->sim
+static void ZHL16_PlannerRestart(ZHL16PlannerJob* job, float depth) {
+    memset(&job->plan, 0, sizeof(AscendPlan));
+    job->current_depth = depth;
+    job->total_time = 0;
+    job->phase = PLANNER_FIRST_LEG;
+}
+
+// Passe un état de simulation en circuit ouvert sur les gaz bailout
+static void ZHL16_SimBailout(const ZHL16Model* model, ZHL16PlannerState* sim) {
+    sim->ccr_mode = false;
+    sim->actual_ppO2 = 0;
+    sim->gas_mask = 0;
+    for (uint8_t i = 0; i < model->num_gases; i++) {
+        if (model->gases[i].is_bailout && model->gases[i].is_enabled) {
+            if (sim->gas_mask == 0) {
+                sim->current_gas = i;   // Premier gaz bailout, comme ZHL16_SwitchToBailout
+            }
+            sim->gas_mask |= 1u << i;
+        }
+    }
+}
+
+// Démarre un calcul de plan sur un instantané compact du modèle
+void ZHL16_PlannerBegin(ZHL16PlannerJob* job, ZHL16Model* model) {
+    ZHL16_TakeSnapshot(model, &job->sim);
+    ZHL16_PlannerRestart(job, model->current_depth);
+    job->bailout = false;
+    job->worst_step /= 2;
+    ZHL16_RecordPlanInputs(model);
     
     if (!ZHL16_NeedsDecoStop(model)) {
-        plan->is_valid = true;
-        plan->tts = (uint16_t)(model->current_depth / model->config.ascent_rate);
-        return;
-    }
-    
-    // Copie temporaire du modèle pour simulation
-    ZHL16Model sim_model = *model;
-    float current_depth = model->current_depth;
-    uint16_t total_time = 0;
-    uint8_t stop_idx = 0;
-    
-    // Remontée jusqu'au premier palier
-    float first_stop = ZHL16_GetCeiling(&sim_model);
-    if (first_stop > 0) {
-        float ascent_time = (current_depth - first_stop) / model->config.ascent_rate;
-        ZHL16_UpdateTissues(&sim_model, ascent_time * 60);
-        total_time += ascent_time;
-        current_depth = first_stop;
-        plan->first_stop_depth = first_stop;
-    }
-    
-    // Calcul des paliers
-    while (current_depth > 0 && stop_idx < MAX_DECO_STOPS) {
-        DecoStop* stop = &plan->stops[stop_idx];
-        stop->depth = current_depth;
-        stop->time = 0;
-        stop->gas_idx = ZHL16_GetBestGas(&sim_model, current_depth);
+        job->plan.is_valid = true;
+        job->plan.tts = (uint16_t)(model->current_depth / model->config.ascent_rate + 0.5f);
+        job->phase = PLANNER_DONE;
+    }
+}
+
+// Démarre le plan bailout circuit ouvert (plan tenu à jour en CCR, publié
+// dans what_if[WHATIF_BAILOUT] et basculé d'un coup au passage en bailout)
+void ZHL16_PlannerBeginBailout(ZHL16PlannerJob* job, ZHL16Model* model) {
+    ZHL16_TakeSnapshot(model, &job->sim);
+    ZHL16_SimBailout(model, &job->sim);
+    ZHL16_PlannerRestart(job, model->current_depth);
+    job->bailout = true;
+    job->worst_step /= 2;
+}
+
+// Une unité de travail bornée : la remontée au premier palier ou un palier
+// (résolution directe + remontée au suivant). Retourne true quand le plan est complet.
+bool ZHL16_PlannerStep(ZHL16PlannerJob* job, ZHL16Model* model) {
+    ZHL16PlannerState* sim = &job->sim;
+    AscendPlan* plan = &job->plan;
+    const DecoConfig* config = &model->config;
+    
+    switch (job->phase) {
+        case PLANNER_FIRST_LEG: {
+            // Remontée jusqu'au premier palier (variation linéaire de pression),
+            // au GF bas s'il est plus profond que l'ancre (la simulation a pu
+            // charger davantage que la plongée réelle) : la droite s'y accroche
+            float first_stop = ZHL16_CeilingFromTissues(model, &sim->tissues, sim->gf);
+            if (first_stop > 0) {
+                float low_stop = ZHL16_CeilingFromTissues(model, &sim->tissues, config->gf_low / 100.0f);
+                if (low_stop > sim->gf_anchor) {
+                    sim->gf_anchor = low_stop;
+                    first_stop = low_stop;
+                }
+            }
+            if (first_stop > 0) {
+                // Facteurs hors cache : remontée au premier palier (durée unique)
+                // et remontée d'un palier au suivant (fixe pour tout le plan)
+                float ascent_time = (job->current_depth - first_stop) / config->ascent_rate;
+                ZHL16_ComputeDecayFactors(model->coeffs, ascent_time * 60, &job->stop_decay);
+                ZHL16_ComputeDecayFactors(model->coeffs, config->last_stop_depth / config->ascent_rate * 60,
+                                          &job->leg_decay);
+                ZHL16_SimMove(model, sim, ZHL16_GetAmbientPressure(first_stop, model->surface_pressure),
+                              &job->stop_decay);
+                job->total_time += ascent_time;
+                job->current_depth = first_stop;
+                plan->first_stop_depth = first_stop;
+                job->phase = PLANNER_STOPS;
+            } else {
+                // Pas de palier : remontée directe
+                job->phase = PLANNER_FINAL_ASCENT;
+            }
+            break;
+        }
+        
+        case PLANNER_STOPS: {
+            if (job->current_depth <= 0 || plan->num_stops >= MAX_DECO_STOPS) {
+                job->phase = PLANNER_FINAL_ASCENT;
+                break;
+            }
+            
+            DecoStop* stop = &plan->stops[plan->num_stops];
+            stop->depth = job->current_depth;
+            stop->time = 0;
+            stop->gas_idx = ZHL16_BestGasAt(model, job->current_depth, sim->current_gas, sim->gas_mask);
+            
+            // Changer de gaz si nécessaire
+            if (stop->gas_idx != sim->current_gas) {
+                sim->current_gas = stop->gas_idx;
+            }
+            
+            // Durée du palier par résolution directe, en minutes entières, au GF
+            // de la droite à la profondeur du palier suivant
+            float next_depth = job->current_depth - config->last_stop_depth;
+            sim->gf = ZHL16_GradientFactorAt(config, sim->gf_anchor, next_depth) / 100.0f;
+            uint16_t minutes = ZHL16_SolveStopMinutes(model, sim, next_depth, ZHL16_MAX_STOP_TIME / 60 + 1);
+            if (minutes > 0) {
+                ZHL16_ComputeDecayFactors(model->coeffs, minutes * 60.0, &job->stop_decay);
+                ZHL16_SimHold(model, sim, &job->stop_decay);
+                stop->time = minutes * 60;
+                job->total_time += minutes;
+            }
+            
+            // Vérification : compléter minute par minute si l'arrondi flottant l'exige
+            while (stop->time <= ZHL16_MAX_STOP_TIME &&
+                   ZHL16_CeilingFromTissues(model, &sim->tissues, sim->gf) > next_depth) {
+                if (job->stop_decay.time_seconds != 60) {
+                    ZHL16_ComputeDecayFactors(model->coeffs, 60, &job->stop_decay); // 1 minute
+                }
+                ZHL16_SimHold(model, sim, &job->stop_decay);
+                stop->time += 60;
+                job->total_time += 1.0f;
+            }
+            
+            if (stop->time > 0) {
+                plan->num_stops++;
+            }
+            
+            // Monter au palier suivant
+            job->current_depth -= config->last_stop_depth;
+            if (job->current_depth > 0) {
+                ZHL16_SimMove(model, sim, ZHL16_GetAmbientPressure(job->current_depth, model->surface_pressure),
+                              &job->leg_decay);
+                job->total_time += config->last_stop_depth / config->ascent_rate;
+            }
+            break;
+        }
+        
+        case PLANNER_FINAL_ASCENT:
+            // Remontée finale
+            if (job->current_depth > 0) {
+                job->total_time += job->current_depth / config->ascent_rate;
+            }
+            plan->tts = (uint16_t)(job->total_time + 0.5f);
+            plan->is_valid = true;
+            job->phase = PLANNER_DONE;
+            break;
         
-        // Changer de gaz si nécessaire
-        if (stop->gas_idx != sim_model.current_gas) {
-            sim_model.current_gas = stop->gas_idx;
+        default:
+            break;
+    }
+    
+    return job->phase == PLANNER_DONE;
+}
+
+// Avance le calcul d'une tranche : au moins une étape (le plan progresse même
+// si une étape a dépassé le budget, ex. interruption), puis d'autres tant que
+// la pire étape observée tient dans le reste du budget (même unité que
+// get_time, ex. cycles). Une tranche ne dépasse donc le budget que d'au plus
+// une étape. Publie le plan et retourne true quand il est complet.
+bool ZHL16_PlannerRun(ZHL16PlannerJob* job, ZHL16Model* model, uint32_t budget,
+                      uint32_t (*get_time)(void)) {
+    if (job->phase == PLANNER_IDLE) return false;
+    
+    uint32_t start = get_time();
+    uint32_t elapsed;
+    
+    do {
+        uint32_t step_start = get_time();
+        ZHL16_PlannerStep(job, model);
+        uint32_t step_time = get_time() - step_start;
+        if (step_time > job->worst_step) {
+            job->worst_step = step_time;
         }
+        elapsed = get_time() - start;
+    } while (job->phase != PLANNER_DONE && elapsed + job->worst_step <= budget);
+    
+    if (job->phase == PLANNER_DONE) {
+        ZHL16_PlannerPublish(job, model);
+        return true;
+    }
+    return false;
+}
+
+// Publie le plan terminé dans le modèle et libère le calcul
+void ZHL16_PlannerPublish(ZHL16PlannerJob* job, ZHL16Model* model) {
+    if (job->bailout) {
+        model->what_if[WHATIF_BAILOUT] = job->plan;
+    } else {
+        model->ascend_plan = job->plan;
+    }
+    job->phase = PLANNER_IDLE;
+}
+
+// Prépare le scénario what_if (ou le suivant) à partir de l'instantané commun.
+// Les scénarios identiques au plan courant sont recopiés sans simulation.
+static void ZHL16_ScenarioStart(ZHL16ScenarioJob* batch, ZHL16Model* model, uint8_t what_if) {
+    ZHL16PlannerJob* job = &batch->job;
+    
+    for (; what_if < WHATIF_COUNT; what_if++) {
+        batch->what_if = what_if;
         
-        // Attendre à ce palier jusqu'à pouvoir monter
-        while (ZHL16_GetCeiling(&sim_model) > (current_depth - model->config.last_stop_depth)) {
-            ZHL16_UpdateTissues(&sim_model, 60); // 1 minute
-            stop->time += 60;
-            total_time++;
+        switch (what_if) {
+            case WHATIF_LOST_GAS:
+                // Reprend le plan courant là où il changeait de gaz : paliers communs réutilisés
+                model->what_if_lost_gas = batch->lost_gas;
+                if (batch->forked) {
+                    *job = batch->fork;
+                    return;
+                }
+                break;
+            
+            case WHATIF_EXTRA_TIME:
+                // Séjour prolongé à la profondeur actuelle, puis remontée
+                job->sim = batch->snapshot;
+                ZHL16_ComputeDecayFactors(model->coeffs, WHATIF_EXTRA_TIME_S, &job->stop_decay);
+                ZHL16_SimHold(model, &job->sim, &job->stop_decay);
+                ZHL16_PlannerRestart(job, batch->start_depth);
+                return;
             
-            if (stop->time > 3600) { // Sécurité : max 1h par palier
+            case WHATIF_BAILOUT:
+                // En CCR, plan tenu à jour à part (ZHL16_PlannerBeginBailout) ;
+                // sans objet en circuit ouvert
+                if (batch->snapshot.ccr_mode) {
+                    continue;
+                }
+                break;
+            
+            default:
                 break;
-            }
         }
         
-        if (stop->time > 0) {
-            stop_idx++;
+        model->what_if[what_if] = model->ascend_plan;
+    }
+    
+    batch->busy = false;
+}
+
+// Démarre le plan courant et les scénarios what-if sur un même instantané
+void ZHL16_ScenariosBegin(ZHL16ScenarioJob* batch, ZHL16Model* model) {
+    ZHL16_TakeSnapshot(model, &batch->snapshot);
+    ZHL16_RecordPlanInputs(model);
+    batch->start_depth = model->current_depth;
+    batch->job.sim = batch->snapshot;
+    ZHL16_PlannerRestart(&batch->job, batch->start_depth);
+    batch->what_if = 0;
+    batch->lost_gas = ZHL16_NO_GAS;
+    batch->forked = false;
+    batch->current_done = false;
+    batch->worst_step /= 2;
+    batch->busy = true;
+}
+
+// Une étape du scénario en cours. Retourne true quand tous les plans sont publiés.
+bool ZHL16_ScenariosStep(ZHL16ScenarioJob* batch, ZHL16Model* model) {
+    ZHL16PlannerJob* job = &batch->job;
+    
+    if (!batch->busy) return true;
+    
+    if (!batch->current_done) {
+        // Bifurcation : le plan courant est mis de côté avant son premier
+        // changement de gaz, le scénario "perte de gaz" en repartira
+        if (!batch->forked && job->phase == PLANNER_STOPS && job->current_depth > 0) {
+            uint8_t gas = ZHL16_BestGasAt(model, job->current_depth, job->sim.current_gas,
+                                          job->sim.gas_mask);
+            if (gas != job->sim.current_gas) {
+                batch->fork = *job;
+                batch->fork.sim.gas_mask &= ~(1u << gas);
+                batch->lost_gas = gas;
+                batch->forked = true;
+            }
         }
         
-        // Monter au palier suivant
-        current_depth -= model->config.last_stop_depth;
-        if (current_depth > 0) {
-            float ascent_time = model->config.last_stop_depth / model->config.ascent_rate;
-            ZHL16_UpdateTissues(&sim_model, ascent_time * 60);
-            total_time += ascent_time;
+        if (ZHL16_PlannerStep(job, model)) {
+            model->ascend_plan = job->plan;
+            batch->current_done = true;
+            ZHL16_ScenarioStart(batch, model, 0);
         }
+    } else if (ZHL16_PlannerStep(job, model)) {
+        model->what_if[batch->what_if] = job->plan;
+        ZHL16_ScenarioStart(batch, model, batch->what_if + 1);
     }
     
-    // Remontée finale
-    if (current_depth > 0) {
-        total_time += current_depth / model->config.ascent_rate;
+    return !batch->busy;
+}
+
+// Avance les scénarios d'une tranche (même règle que ZHL16_PlannerRun)
+bool ZHL16_ScenariosRun(ZHL16ScenarioJob* batch, ZHL16Model* model, uint32_t budget,
+                        uint32_t (*get_time)(void)) {
+    if (!batch->busy) return false;
+    
+    uint32_t start = get_time();
+    uint32_t elapsed;
+    
+    do {
+        uint32_t step_start = get_time();
+        ZHL16_ScenariosStep(batch, model);
+        uint32_t step_time = get_time() - step_start;
+        if (step_time > batch->worst_step) {
+            batch->worst_step = step_time;
+        }
+        elapsed = get_time() - start;
+    } while (batch->busy && elapsed + batch->worst_step <= budget);
+    
+    return !batch->busy;
+}
+
+// exp(-k·t) connaissant sa valeur en t_ref : série d'ordre 4 pour un petit pas
+// (sans exponentielle), calcul complet sinon ou si la référence est inconnue (< 0)
+static float ZHL16_DecayFrom(float k, float t, float t_ref, float decay_ref) {
+    float x = k * (t - t_ref);
+    if (decay_ref >= 0 && fabsf(x) < ZHL16_NDL_SERIES_MAX) {
+        return decay_ref * (1.0f - x * (1.0f - x * (0.5f - x * (1.0f / 6.0f - x / 24.0f))));
     }
+    return ZHL16_EXP_NEG(k * t);
+}
+
+// Signe de (pression tolérée - pression de surface) du compartiment i, sous
+// forme sans division (h), et sa dérivée en temps (dh), une fois les écarts
+// tissu - inspiré g_N2/g_He réduits des facteurs exp(-k·t) donnés (1 :
+// maintenant, 0 : asymptote). Tolérée = (P - gf·A/P) / (gf·P/B - gf + 1) avec
+// A, B sommes pondérées de a, b : h = P·B·(tolérée - Ps) · (gf·P/B - gf + 1)
+static void ZHL16_NDLMargin(const ZHL16Coefficients* c, int i, float g_N2, float g_He,
+                            float inspired_N2, float inspired_He, float gf,
+                            float surface_pressure, float decay_N2, float decay_He,
+                            float* h, float* dh) {
+    float a_N2 = ZHL16_REAL_F(c->a_N2[i]);
+    float a_He = ZHL16_REAL_F(c->a_He[i]);
+    float b_N2 = ZHL16_REAL_F(c->b_N2[i]);
+    float b_He = ZHL16_REAL_F(c->b_He[i]);
+    
+    g_N2 *= decay_N2;
+    g_He *= decay_He;
+    float p_N2 = inspired_N2 + g_N2;
+    float p_He = inspired_He + g_He;
+    float dp_N2 = -ZHL16_FRACTION_F(c->k_N2[i]) * g_N2;
+    float dp_He = -ZHL16_FRACTION_F(c->k_He[i]) * g_He;
     
-    plan->num_stops = stop_idx;
-    plan->tts = total_time;
-    plan->is_valid = true;
+    float p = p_N2 + p_He;
+    float dp = dp_N2 + dp_He;
+    float sum_a = a_N2 * p_N2 + a_He * p_He;
+    float sum_b = b_N2 * p_N2 + b_He * p_He;
+    float d_sum_a = a_N2 * dp_N2 + a_He * dp_He;
+    float d_sum_b = b_N2 * dp_N2 + b_He * dp_He;
+    float ps_gf = surface_pressure * (gf - 1.0f);
+    
+    // h = B·(P² + Ps·(gf - 1)·P - gf·A) - Ps·gf·P²
+    float q = p * p + ps_gf * p - gf * sum_a;
+    float dq = 2.0f * p * dp + ps_gf * dp - gf * d_sum_a;
+    *h = sum_b * q - surface_pressure * gf * p * p;
+    *dh = d_sum_b * q + sum_b * dq - 2.0f * surface_pressure * gf * p * dp;
 }
 
-// Calcul du NDL
-float ZHL16_GetNDL(ZHL16Model* model) {
-    if (ZHL16_NeedsDecoStop(model)) {
-        return 0.0;
+// Signe seul de la même marge pour des pressions tissulaires données
+static float ZHL16_NDLSign(const ZHL16Coefficients* c, int i, float p_N2, float p_He,
+                           float gf, float surface_pressure) {
+    float p = p_N2 + p_He;
+    float sum_a = ZHL16_REAL_F(c->a_N2[i]) * p_N2 + ZHL16_REAL_F(c->a_He[i]) * p_He;
+    float sum_b = ZHL16_REAL_F(c->b_N2[i]) * p_N2 + ZHL16_REAL_F(c->b_He[i]) * p_He;
+    return sum_b * (p * p + surface_pressure * (gf - 1.0f) * p - gf * sum_a) -
+           surface_pressure * gf * p * p;
+}
+
+// Minutes avant que le compartiment i n'atteigne la M-value de surface à
+// pression inspirée constante (ZHL16_NDL_NEVER si pas avant NDL_MAX_MIN).
+// N2 seul : inversion logarithmique de Schreiner. N2 + He : Newton sur la
+// trajectoire combinée, borné par un encadrement (dichotomie si Newton en sort).
+// guess >= 0 : point de départ, *decay_N2/*decay_He valant exp(-k·guess_ref)
+// (< 0 si inconnus) ; guess < 0 : estimation à a/b figés sur le gaz inspiré.
+// Si une borne basse dépasse skip_above, elle est retournée telle quelle
+// (compartiment non directeur). En sortie, les facteurs exp(-k·t) de l'instant
+// retourné (< 0 si inconnus).
+static float ZHL16_SolveNDLCrossing(const ZHL16Coefficients* c, int i, float p_N2, float p_He,
+                                    float inspired_N2, float inspired_He, float gf,
+                                    float surface_pressure, float guess, float guess_ref,
+                                    float skip_above, float* decay_N2, float* decay_He) {
+    float k_N2 = ZHL16_FRACTION_F(c->k_N2[i]);
+    float k_He = ZHL16_FRACTION_F(c->k_He[i]);
+    float g_N2 = p_N2 - inspired_N2;
+    float g_He = p_He - inspired_He;
+    float f_N2 = -1.0f;
+    float f_He = -1.0f;
+    if (guess >= 0) {
+        f_N2 = *decay_N2;
+        f_He = *decay_He;
+    }
+    
+    if (p_He <= 0 && inspired_He <= 0) {
+        // a et b constants : p_N2(t) <= p_limit, exp(-k·t) = ratio
+        float p_limit = surface_pressure * (gf / ZHL16_REAL_F(c->b_N2[i]) - gf + 1.0f) +
+                        ZHL16_REAL_F(c->a_N2[i]) * gf;
+        *decay_N2 = 1.0f;
+        *decay_He = -1.0f;
+        if (p_N2 >= p_limit) return 0.0f;
+        if (inspired_N2 <= p_limit) return ZHL16_NDL_NEVER;
+        float ratio = (p_limit - inspired_N2) / g_N2;
+        float t = -ZHL16_LOG(ratio) / k_N2;
+        *decay_N2 = ratio;
+        return t < NDL_MAX_MIN ? t : ZHL16_NDL_NEVER;
     }
     
-    float ndl = 999.0;
-    GasMix* gas = &model->gases[model->current_gas];
+    // Borne basse sans Newton : la pression totale monte au plus à la vitesse
+    // du He vers P + écarts entrants, la M-value est au moins celle du gaz le
+    // moins tolérant
+    float a_min = fminf(ZHL16_REAL_F(c->a_N2[i]), ZHL16_REAL_F(c->a_He[i]));
+    float b_max = fmaxf(ZHL16_REAL_F(c->b_N2[i]), ZHL16_REAL_F(c->b_He[i]));
+    float rise = (g_N2 < 0 ? -g_N2 : 0.0f) + (g_He < 0 ? -g_He : 0.0f);
+    float headroom = a_min * gf + surface_pressure * (gf / b_max - gf + 1.0f) - (p_N2 + p_He);
+    *decay_N2 = -1.0f;
+    *decay_He = -1.0f;
+    if (headroom >= rise) return ZHL16_NDL_NEVER;
+    if (headroom > 0) {
+        float bound = -ZHL16_LOG(1.0f - headroom / rise) / k_He;
+        if (bound >= skip_above) return bound < NDL_MAX_MIN ? bound : ZHL16_NDL_NEVER;
+    }
     
-    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
-        Compartment* comp = &model->compartments[i];
-        
-        float inspired_N2, inspired_He;
-        if (model->ccr_mode) {
-            float diluent_pressure = model->ambient_pressure - model->actual_ppO2;
-            float total_inert = gas->fN2 + gas->fHe;
-            inspired_N2 = diluent_pressure * (gas->fN2 / total_inert);
-            inspired_He = diluent_pressure * (gas->fHe / total_inert);
+    float h, dh;
+    float lo = 0.0f;
+    float hi = NDL_MAX_MIN;
+    
+    if (headroom <= 0 && ZHL16_NDLSign(c, i, p_N2, p_He, gf, surface_pressure) >= 0) {
+        *decay_N2 = 1.0f;
+        *decay_He = 1.0f;
+        return 0.0f;
+    }
+    
+    // Asymptote (sans exponentielle) au-dessus de la limite : une seule racine,
+    // la pression totale n'ayant au plus qu'un extremum. En dessous, seul un He
+    // entrant plus vite que le N2 ne sort (contre-diffusion) peut dépasser la
+    // limite de façon transitoire, au maximum t* de la pression totale.
+    if (ZHL16_NDLSign(c, i, inspired_N2, inspired_He, gf, surface_pressure) < 0) {
+        float rate_N2 = k_N2 * g_N2;
+        float rate_He = -k_He * g_He;
+        if (rate_N2 <= ZHL16_NDL_MIN_RATE || rate_He <= ZHL16_NDL_MIN_RATE) {
+            return ZHL16_NDL_NEVER;
+        }
+        float t_peak = (ZHL16_LOG(rate_He) - ZHL16_LOG(rate_N2)) / (k_He - k_N2);
+        if (t_peak <= 0 || t_peak >= NDL_MAX_MIN) {
+            return ZHL16_NDL_NEVER;
+        }
+        ZHL16_NDLMargin(c, i, g_N2, g_He, inspired_N2, inspired_He, gf, surface_pressure,
+                        ZHL16_EXP_NEG(k_N2 * t_peak), ZHL16_EXP_NEG(k_He * t_peak), &h, &dh);
+        if (h < 0) {
+            return ZHL16_NDL_NEVER;
+        }
+        hi = t_peak;
+    }
+    
+    // Point de départ : instant précédent, sinon a/b du gaz inspiré et
+    // constante k pondérée par les écarts
+    float t = guess;
+    if (guess < 0) {
+        float inspired = inspired_N2 + inspired_He;
+        float a = (ZHL16_REAL_F(c->a_N2[i]) * inspired_N2 + ZHL16_REAL_F(c->a_He[i]) * inspired_He) / inspired;
+        float b = (ZHL16_REAL_F(c->b_N2[i]) * inspired_N2 + ZHL16_REAL_F(c->b_He[i]) * inspired_He) / inspired;
+        float p_limit = surface_pressure * (gf / b - gf + 1.0f) + a * gf;
+        float ratio = (p_limit - inspired) / (g_N2 + g_He);
+        float k = (k_N2 * g_N2 + k_He * g_He) / (g_N2 + g_He);
+        if (ratio > 0 && ratio < 1 && k > 0) {
+            t = -ZHL16_LOG(ratio) / k;
+        }
+    }
+    if (t <= lo || t >= hi) {
+        t = (lo + hi) / 2;
+        guess = -1.0f;
+    }
+    if (guess >= 0) {
+        f_N2 = ZHL16_DecayFrom(k_N2, t, guess_ref, f_N2);
+        f_He = ZHL16_DecayFrom(k_He, t, guess_ref, f_He);
+    } else {
+        f_N2 = ZHL16_EXP_NEG(k_N2 * t);
+        f_He = ZHL16_EXP_NEG(k_He * t);
+    }
+    
+    for (int iter = 0; iter < ZHL16_NDL_MAX_ITER; iter++) {
+        ZHL16_NDLMargin(c, i, g_N2, g_He, inspired_N2, inspired_He, gf, surface_pressure,
+                        f_N2, f_He, &h, &dh);
+        if (h < 0) {
+            lo = t;
         } else {
-            inspired_N2 = (model->ambient_pressure - model->water_vapor_pressure) * gas->fN2;
-            inspired_He = (model->ambient_pressure - model->water_vapor_pressure) * gas->fHe;
+            hi = t;
         }
         
-        // M-value à la surface avec GF high
-        float gf = model->config.gf_high / 100.0;
-        float m_value_surface = (model->surface_pressure - comp->a_N2 * gf) / 
-                               (comp->b_N2 - gf + 1.0);
+        float next = dh > 0 ? t - h / dh : hi;
+        bool newton = next > lo && next < hi;
+        if (!newton) {
+            next = (lo + hi) / 2;
+        }
+        f_N2 = ZHL16_DecayFrom(k_N2, next, t, f_N2);
+        f_He = ZHL16_DecayFrom(k_He, next, t, f_He);
         
-        // Temps restant pour N2
-        if (inspired_N2 > comp->pressure_N2 && comp->pressure_N2 < m_value_surface) {
-            float k = 0.693147 / comp->half_time_N2;
-            float remaining = -logf((m_value_surface - inspired_N2) / 
-                                   (comp->pressure_N2 - inspired_N2)) / k;
-            if (remaining < ndl) ndl = remaining;
+        // Newton converge quadratiquement : erreur après le pas ~ k·pas² (k_He > k_N2)
+        float step = next - t;
+        if (newton ? k_He * step * step < ZHL16_NDL_TOL_MIN : hi - lo < ZHL16_NDL_TOL_MIN) {
+            if (next >= NDL_MAX_MIN) return ZHL16_NDL_NEVER;
+            *decay_N2 = f_N2;
+            *decay_He = f_He;
+            return next;
         }
+        t = next;
+    }
+    
+    // Pas de convergence : borne basse (prudente), facteurs inconnus
+    *decay_N2 = -1.0f;
+    *decay_He = -1.0f;
+    return lo;
+}
+
+// Calcul du NDL : temps avant que la remontée directe (GF high) ne demande un
+// palier. Les instants d'atteinte par compartiment sont mémorisés avec leurs
+// facteurs exp(-k·t) : avancés du temps écoulé tant que les pressions inspirées
+// ne changent pas, point de départ de Newton (sans exponentielle) sinon.
+float ZHL16_GetNDL(ZHL16Model* model) {
+    if (ZHL16_NeedsDecoStop(model)) {
+        return 0.0f;
+    }
+    
+    ZHL16NDLCache* cache = &model->ndl_cache;
+    const ZHL16Coefficients* c = model->coeffs;
+    const TissueState* t = &model->tissues;
+    float now = model->dive_time_seconds / 60.0f;
+    float gf = model->config.gf_high / 100.0f;
+    float inspired_N2, inspired_He;
+    
+    ZHL16_GetInspiredPressures(model, model->ambient_pressure, &inspired_N2, &inspired_He);
+    
+    // Réutilisation : pressions inspirées inchangées ou plus basses (les tissus
+    // chargent moins que prévu, les instants mémorisés restent prudents)
+    bool reuse = cache->valid &&
+                 model->dive_time_seconds - cache->checked_at <= NDL_CACHE_MAX_GAP_S &&
+                 inspired_N2 - cache->inspired_N2 <= NDL_INSPIRED_RISE_BAR &&
+                 inspired_He - cache->inspired_He <= NDL_INSPIRED_RISE_BAR &&
+                 cache->inspired_N2 - inspired_N2 <= NDL_INSPIRED_FALL_BAR &&
+                 cache->inspired_He - inspired_He <= NDL_INSPIRED_FALL_BAR &&
+                 gf == cache->gf;
+    
+    if (!reuse) {
+        float solved = cache->solved_at / 60.0f;
+        float ndl = NDL_MAX_MIN;
         
-        // Temps restant pour He
-        if (gas->fHe > 0 && inspired_He > comp->pressure_He) {
-            float m_value_He = (model->surface_pressure - comp->a_He * gf) / 
-                              (comp->b_He - gf + 1.0);
-            if (comp->pressure_He < m_value_He) {
-                float k = 0.693147 / comp->half_time_He;
-                float remaining = -logf((m_value_He - inspired_He) / 
-                                       (comp->pressure_He - inspired_He)) / k;
-                if (remaining < ndl) ndl = remaining;
+        // Compartiment directeur précédent d'abord : le minimum courant écarte
+        // ensuite la plupart des autres par leur borne basse
+        for (int n = 0; n < NUM_COMPARTMENTS; n++) {
+            int i = (cache->leading + n) % NUM_COMPARTMENTS;
+            float guess = -1.0f;
+            float guess_ref = 0.0f;
+            float decay_N2 = cache->decay_N2[i];
+            float decay_He = cache->decay_He[i];
+            
+            // Départ de l'instant précédent (facteurs vus de la résolution précédente)
+            if (cache->valid && cache->crossing_min[i] < ZHL16_NDL_NEVER) {
+                guess = cache->crossing_min[i] - now;
+                guess_ref = cache->crossing_min[i] - solved;
             }
+            
+            float crossing = ZHL16_SolveNDLCrossing(c, i, ZHL16_PRESSURE_F(t->pressure_N2[i]),
+                                                    ZHL16_PRESSURE_F(t->pressure_He[i]),
+                                                    inspired_N2, inspired_He, gf,
+                                                    model->surface_pressure, guess, guess_ref,
+                                                    ndl, &decay_N2, &decay_He);
+            cache->crossing_min[i] = crossing < ZHL16_NDL_NEVER ? now + crossing : ZHL16_NDL_NEVER;
+            cache->decay_N2[i] = decay_N2;
+            cache->decay_He[i] = decay_He;
+            if (crossing < ndl) ndl = crossing;
         }
+        cache->inspired_N2 = inspired_N2;
+        cache->inspired_He = inspired_He;
+        cache->gf = gf;
+        cache->solved_at = model->dive_time_seconds;
+        cache->valid = true;
+        model->ndl_solve_count++;
     }
+    cache->checked_at = model->dive_time_seconds;
+    
+    float ndl = NDL_MAX_MIN;
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        float remaining = cache->crossing_min[i] - now;
+        if (remaining < ndl) {
+            ndl = remaining;
+            cache->leading = i;
+        }
+    }
+    if (ndl < 0) ndl = 0.0f;
     
     model->ndl = ndl;
     return ndl;
@@ -333,33 +1261,298 @@ void ZHL16_AddGas(ZHL16Model* model, uint8_t idx, const char* name,
     if (idx >= model->num_gases) {
         model->num_gases = idx + 1;
     }
+    ZHL16_BuildGasSchedule(model);
+    ZHL16_InvalidatePlan(model);
 }
 
-// Calcul du meilleur gaz
-uint8_t ZHL16_GetBestGas(ZHL16Model* model, float depth) {
-    uint8_t best_gas = model->current_gas;
-    float best_ppO2 = 0;
+// Limites de ppO2 d'un gaz (MOD recalculée, table de changement reconstruite)
+void ZHL16_SetGasLimits(ZHL16Model* model, uint8_t idx, float ppO2_min, float ppO2_max) {
+    if (idx >= model->num_gases) return;
+    
+    GasMix* gas = &model->gases[idx];
+    gas->ppO2_min = ppO2_min;
+    gas->ppO2_max = ppO2_max;
+    gas->mod = ZHL16_CalculateMOD(gas->fO2, ppO2_max);
+    ZHL16_BuildGasSchedule(model);
+    ZHL16_InvalidatePlan(model);
+}
+
+// Activation d'un gaz (table de changement reconstruite)
+void ZHL16_EnableGas(ZHL16Model* model, uint8_t idx, bool enabled) {
+    if (idx >= model->num_gases) return;
+    
+    model->gases[idx].is_enabled = enabled;
+    ZHL16_BuildGasSchedule(model);
+    ZHL16_InvalidatePlan(model);
+}
+
+// Insère une borne dans la liste croissante (doublons ignorés)
+static void ZHL16_InsertBound(ZHL16GasSchedule* sched, float depth) {
+    uint8_t n = sched->num_bounds;
+    for (uint8_t j = 0; j < n; j++) {
+        if (sched->bound[j] == depth) return;
+    }
+    while (n > 0 && sched->bound[n - 1] > depth) {
+        sched->bound[n] = sched->bound[n - 1];
+        n--;
+    }
+    sched->bound[n] = depth;
+    sched->num_bounds++;
+}
+
+// Table de changement de gaz : profondeurs min/max de chaque gaz activé à la
+// pression de surface du modèle, triées en bornes de segments ; par segment,
+// gaz respirables et meilleur gaz (fO2 la plus haute : ppO2 la plus haute à
+// profondeur égale, premier indice en cas d'égalité)
+void ZHL16_BuildGasSchedule(ZHL16Model* model) {
+    ZHL16GasSchedule* sched = &model->gas_schedule;
+    float min_depth[MAX_GASES];
+    float max_depth[MAX_GASES];
     
+    sched->num_bounds = 0;
+    sched->num_ordered = 0;
     for (uint8_t i = 0; i < model->num_gases; i++) {
-        GasMix* gas = &model->gases[i];
-        if (!gas->is_enabled) continue;
+        const GasMix* gas = &model->gases[i];
+        if (!gas->is_enabled || gas->fO2 <= 0) continue;
         
-        float ppO2 = ZHL16_GetPartialPressure(
-            ZHL16_GetAmbientPressure(depth, model->surface_pressure), 
-            gas->fO2
-        );
+        min_depth[i] = (gas->ppO2_min / gas->fO2 - model->surface_pressure) * 10.0f;
+        max_depth[i] = (gas->ppO2_max / gas->fO2 - model->surface_pressure) * 10.0f;
+        ZHL16_InsertBound(sched, min_depth[i]);
+        ZHL16_InsertBound(sched, max_depth[i]);
         
-        // Vérifier les limites
-        if (ppO2 > gas->ppO2_max || ppO2 < gas->ppO2_min) continue;
+        uint8_t n = sched->num_ordered++;
+        while (n > 0 && model->gases[sched->order[n - 1]].fO2 < gas->fO2) {
+            sched->order[n] = sched->order[n - 1];
+            n--;
+        }
+        sched->order[n] = i;
+    }
+    
+    // Segment s : ]bound[s-1], bound[s]], ouvert aux extrémités. Un gaz y est
+    // respirable si ses deux limites l'encadrent (elles sont des bornes).
+    for (uint8_t s = 0; s <= sched->num_bounds; s++) {
+        float lo = s > 0 ? sched->bound[s - 1] : -INFINITY;
+        float hi = s < sched->num_bounds ? sched->bound[s] : INFINITY;
+        sched->breathable[s] = 0;
+        sched->best[s] = ZHL16_NO_GAS;
         
-        // Préférer le gaz avec la ppO2 la plus élevée (dans les limites)
-        if (ppO2 > best_ppO2) {
-            best_ppO2 = ppO2;
-            best_gas = i;
+        for (uint8_t r = 0; r < sched->num_ordered; r++) {
+            uint8_t g = sched->order[r];
+            if (min_depth[g] <= lo && max_depth[g] >= hi) {
+                sched->breathable[s] |= 1u << g;
+                if (sched->best[s] == ZHL16_NO_GAS) sched->best[s] = g;
+            }
         }
     }
+}
+
+// Segment de la table contenant une profondeur (recherche dichotomique)
+static uint8_t ZHL16_ScheduleSegment(const ZHL16GasSchedule* sched, float depth) {
+    uint8_t lo = 0;
+    uint8_t hi = sched->num_bounds;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi) / 2;
+        if (sched->bound[mid] < depth) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Profondeur de passage sur un gaz à la remontée : la plus profonde où il est
+// le meilleur gaz tous gaz confondus (-1 si jamais)
+float ZHL16_GetSwitchDepth(const ZHL16Model* model, uint8_t gas_idx) {
+    const ZHL16GasSchedule* sched = &model->gas_schedule;
+    
+    for (int s = sched->num_bounds - 1; s >= 0; s--) {
+        if (sched->best[s] == gas_idx) {
+            return sched->bound[s];
+        }
+    }
+    return -1.0f;
+}
+
+// Changement de gaz (gaz configuré et activé uniquement)
+bool ZHL16_SwitchGas(ZHL16Model* model, uint8_t gas_idx) {
+    if (gas_idx >= model->num_gases || !model->gases[gas_idx].is_enabled) {
+        return false;
+    }
     
-    return best_gas;
+    model->current_gas = gas_idx;
+    return true;
+}
+
+// Intervalle de surface : avance exacte des tissus à l'air en surface
+// (Schreiner à pression constante) sur toute la durée écoulée, par pas de
+// SURFACE_MAX_STEP_S au plus, et décroissance du CNS et des OTU
+void ZHL16_SurfaceInterval(ZHL16Model* model, uint32_t seconds) {
+    DecayFactors decay;
+    float inspired_N2 = (model->surface_pressure - model->water_vapor_pressure) * 0.79f;
+    
+    model->cns *= ZHL16T_CNSDecay(seconds);
+    model->otu *= ZHL16T_OTUDecay(seconds);
+    model->nofly_minimum = fmaxf(model->nofly_minimum - seconds / 60.0f, 0.0f);
+    
+    while (seconds > 0) {
+        uint32_t step = seconds < SURFACE_MAX_STEP_S ? seconds : SURFACE_MAX_STEP_S;
+        ZHL16_ComputeDecayFactors(model->coeffs, (float)step, &decay);
+        ZHL16K_UpdateTissues(&model->tissues, &decay, inspired_N2, 0.0f);
+        seconds -= step;
+    }
+    
+    ZHL16K_UpdateMix(&model->tissues, model->coeffs);
+    model->saturation_percent = ZHL16K_UpdateLoading(&model->tissues, model->surface_pressure,
+                                                     &model->leading_compartment);
+    model->tissue_ambient_pressure = model->surface_pressure;
+    model->ndl_cache.valid = false;
+    model->ceiling_state.valid = false;
+}
+
+// Minutes avant désaturation : sursaturation N2 + He de chaque compartiment
+// sous DESAT_EXCESS_BAR, à l'air en surface. La somme des écarts décroissants
+// est convexe : Newton depuis la plus tardive des atteintes de chaque gaz seul
+// (borne basse) converge par valeurs inférieures, sans encadrement.
+float ZHL16_GetDesatTime(ZHL16Model* model) {
+    const ZHL16Coefficients* c = model->coeffs;
+    float inspired_N2 = (model->surface_pressure - model->water_vapor_pressure) * 0.79f;
+    float log_excess = ZHL16_LOG(DESAT_EXCESS_BAR);
+    float desat = 0.0f;
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        float k_N2 = ZHL16_FRACTION_F(c->k_N2[i]);
+        float k_He = ZHL16_FRACTION_F(c->k_He[i]);
+        float g_N2 = fmaxf(ZHL16_PRESSURE_F(model->tissues.pressure_N2[i]) - inspired_N2, 0.0f);
+        float g_He = ZHL16_PRESSURE_F(model->tissues.pressure_He[i]);
+        if (g_N2 + g_He <= DESAT_EXCESS_BAR) continue;
+        
+        float t = 0.0f;
+        if (g_N2 > DESAT_EXCESS_BAR) t = (ZHL16_LOG(g_N2) - log_excess) / k_N2;
+        if (g_He > DESAT_EXCESS_BAR) t = fmaxf(t, (ZHL16_LOG(g_He) - log_excess) / k_He);
+        
+        for (int iter = 0; iter < ZHL16_NDL_MAX_ITER; iter++) {
+            float e_N2 = g_N2 * ZHL16_EXP_NEG(k_N2 * t);
+            float e_He = g_He * ZHL16_EXP_NEG(k_He * t);
+            float step = (e_N2 + e_He - DESAT_EXCESS_BAR) / (k_N2 * e_N2 + k_He * e_He);
+            t += step;
+            if (step < ZHL16_NDL_TOL_MIN) break;
+        }
+        if (t > desat) desat = t;
+    }
+    
+    model->desat_time = desat;
+    return desat;
+}
+
+// Minutes avant que la pression tolérée du compartiment i ne descende sous
+// limit, à l'air en surface (dégazage). N2 seul : inversion logarithmique.
+// N2 + He : majorant analytique (a/b les moins tolérants, écarts décroissant
+// au moins comme le N2), retourné tel quel s'il ne dépasse pas skip_below
+// (compartiment non directeur), puis Newton borné sur la marge de
+// ZHL16_NDLMargin (dichotomie si Newton sort de l'encadrement).
+static float ZHL16_SolveOffgasTime(const ZHL16Coefficients* c, int i, float p_N2, float p_He,
+                                   float inspired_N2, float gf, float limit, float skip_below) {
+    float k_N2 = ZHL16_FRACTION_F(c->k_N2[i]);
+    float k_He = ZHL16_FRACTION_F(c->k_He[i]);
+    float g_N2 = p_N2 - inspired_N2;
+    
+    if (p_He <= 0) {
+        float p_limit = limit * (gf / ZHL16_REAL_F(c->b_N2[i]) - gf + 1.0f) +
+                        ZHL16_REAL_F(c->a_N2[i]) * gf;
+        if (p_N2 <= p_limit) return 0.0f;
+        if (inspired_N2 >= p_limit) return ZHL16_NDL_NEVER;
+        return (ZHL16_LOG(g_N2) - ZHL16_LOG(p_limit - inspired_N2)) / k_N2;
+    }
+    
+    float a_min = fminf(ZHL16_REAL_F(c->a_N2[i]), ZHL16_REAL_F(c->a_He[i]));
+    float b_max = fmaxf(ZHL16_REAL_F(c->b_N2[i]), ZHL16_REAL_F(c->b_He[i]));
+    float p_limit_min = limit * (gf / b_max - gf + 1.0f) + a_min * gf;
+    if (p_N2 + p_He <= p_limit_min) return 0.0f;
+    if (inspired_N2 >= p_limit_min) return ZHL16_NDL_NEVER;
+    
+    float hi = (ZHL16_LOG(fmaxf(g_N2, 0.0f) + p_He) - ZHL16_LOG(p_limit_min - inspired_N2)) / k_N2;
+    if (hi <= skip_below) return hi;
+    if (ZHL16_NDLSign(c, i, p_N2, p_He, gf, limit) < 0) return 0.0f;
+    
+    // h >= 0 : tolérée au-dessus de la limite (vol interdit)
+    float h, dh;
+    float lo = 0.0f;
+    float t = hi / 2;
+    for (int iter = 0; iter < ZHL16_NDL_MAX_ITER; iter++) {
+        ZHL16_NDLMargin(c, i, g_N2, p_He, inspired_N2, 0.0f, gf, limit,
+                        ZHL16_EXP_NEG(k_N2 * t), ZHL16_EXP_NEG(k_He * t), &h, &dh);
+        if (h >= 0) {
+            lo = t;
+        } else {
+            hi = t;
+        }
+        
+        float next = dh < 0 ? t - h / dh : lo;
+        if (next <= lo || next >= hi) {
+            next = (lo + hi) / 2;
+        }
+        if (fabsf(next - t) < ZHL16_NDL_TOL_MIN) {
+            return next;
+        }
+        t = next;
+    }
+    
+    // Pas de convergence : borne haute (prudente)
+    return hi;
+}
+
+// Minutes avant de pouvoir prendre l'avion : pression tolérée (GF haut) de
+// chaque compartiment sous NOFLY_CABIN_PRESSURE_BAR, à l'air en surface.
+// Le compartiment directeur précédent d'abord, les autres écartés par leur
+// majorant. Jamais moins que le reste de l'interdiction minimale posée par
+// ZHL16_EndDive (12/18/24 h).
+float ZHL16_GetNoFlyTime(ZHL16Model* model) {
+    const ZHL16Coefficients* c = model->coeffs;
+    const TissueState* t = &model->tissues;
+    float inspired_N2 = (model->surface_pressure - model->water_vapor_pressure) * 0.79f;
+    float gf = model->config.gf_high / 100.0f;
+    float nofly = 0.0f;
+    
+    for (int n = 0; n < NUM_COMPARTMENTS; n++) {
+        int i = (model->leading_compartment + n) % NUM_COMPARTMENTS;
+        float time = ZHL16_SolveOffgasTime(c, i, ZHL16_PRESSURE_F(t->pressure_N2[i]),
+                                           ZHL16_PRESSURE_F(t->pressure_He[i]), inspired_N2,
+                                           gf, NOFLY_CABIN_PRESSURE_BAR, nofly);
+        if (time > nofly) nofly = time;
+    }
+    if (model->nofly_minimum > nofly) {
+        nofly = model->nofly_minimum;
+    }
+    
+    model->nofly_time = nofly;
+    return nofly;
+}
+
+// Meilleur gaz du masque à une profondeur (fallback si aucun gaz n'est
+// respirable) : segment de la table de changement, meilleur gaz précalculé si
+// le masque couvre tous ses gaz respirables, sinon premier gaz du masque par
+// fO2 décroissante
+static uint8_t ZHL16_BestGasAt(const ZHL16Model* model, float depth, uint8_t fallback,
+                               uint16_t gas_mask) {
+    const ZHL16GasSchedule* sched = &model->gas_schedule;
+    uint8_t s = ZHL16_ScheduleSegment(sched, depth);
+    uint16_t usable = sched->breathable[s] & gas_mask;
+    
+    if (usable == sched->breathable[s]) {
+        return sched->best[s] != ZHL16_NO_GAS ? sched->best[s] : fallback;
+    }
+    for (uint8_t r = 0; r < sched->num_ordered; r++) {
+        if (usable & (1u << sched->order[r])) {
+            return sched->order[r];
+        }
+    }
+    return fallback;
+}
+
+// Calcul du meilleur gaz
+uint8_t ZHL16_GetBestGas(ZHL16Model* model, float depth) {
+    return ZHL16_BestGasAt(model, depth, model->current_gas, ZHL16_ALL_GASES);
 }
 
 // Calcul MOD
@@ -376,45 +1569,39 @@ float ZHL16_CalculateEND(float depth, float fN2) {
     return (narcotic_pressure / 0.79 - 1.0) * 10.0;
 }
 
-// Toxicité O2 - CNS
+// ppO2 inspirée : mesurée en CCR, gaz courant en circuit ouvert
+static float ZHL16_InspiredPPO2(const ZHL16Model* model) {
+    if (model->ccr_mode) {
+        return model->actual_ppO2;
+    }
+    return ZHL16_GetPartialPressure(model->ambient_pressure, model->gases[model->current_gas].fO2);
+}
+
+// Toxicité O2 - CNS : taux NOAA interpolé, élimination sous 0.5 bar
 void ZHL16_UpdateCNS(ZHL16Model* model, float time_seconds) {
-    float ppO2;
+    float ppO2 = ZHL16_InspiredPPO2(model);
     
-    if (model->ccr_mode) {
-        ppO2 = model->actual_ppO2;
-    } else {
-        GasMix* gas = &model->gases[model->current_gas];
-        ppO2 = ZHL16_GetPartialPressure(model->ambient_pressure, gas->fO2);
+    model->cns += ZHL16T_CNSRate(ppO2) * time_seconds / 60.0f;
+    if (ppO2 < TOX_PPO2_MIN) {
+        model->cns *= ZHL16T_CNSDecay(time_seconds);
     }
     
-    float cns_rate = ZHL16_GetCNSAtDepth(ppO2);
-    model->cns += (cns_rate * time_seconds / 60.0);
+    if (model->cns > 100.0f) model->cns = 100.0f;
+}
+
+// Toxicité O2 - OTU : dose pulmonaire, récupération sous 0.5 bar
+void ZHL16_UpdateOTU(ZHL16Model* model, float time_seconds) {
+    float ppO2 = ZHL16_InspiredPPO2(model);
     
-    // Décroissance en surface
-    if (ppO2 < 0.5) {
-        float half_time = 90.0; // minutes
-        model->cns *= expf(-0.693147 * time_seconds / (half_time * 60));
+    model->otu += ZHL16T_OTURate(ppO2) * time_seconds / 60.0f;
+    if (ppO2 < TOX_PPO2_MIN) {
+        model->otu *= ZHL16T_OTUDecay(time_seconds);
     }
-    
-    if (model->cns > 100.0) model->cns = 100.0;
-    if (model->cns < 0.0) model->cns = 0.0;
 }
 
-// Table NOAA CNS
+// Taux CNS NOAA (%/min), interpolé entre les paliers de 0.1 bar
 float ZHL16_GetCNSAtDepth(float ppO2) {
-    if (ppO2 <= 0.5) return 0.0;
-    else if (ppO2 <= 0.6) return 100.0 / 720.0;  // 0.14%/min
-    else if (ppO2 <= 0.7) return 100.0 / 570.0;  // 0.18%/min
-    else if (ppO2 <= 0.8) return 100.0 / 450.0;  // 0.22%/min
-    else if (ppO2 <= 0.9) return 100.0 / 360.0;  // 0.28%/min
-    else if (ppO2 <= 1.0) return 100.0 / 300.0;  // 0.33%/min
-    else if (ppO2 <= 1.1) return 100.0 / 240.0;  // 0.42%/min
-    else if (ppO2 <= 1.2) return 100.0 / 210.0;  // 0.48%/min
-    else if (ppO2 <= 1.3) return 100.0 / 180.0;  // 0.56%/min
-    else if (ppO2 <= 1.4) return 100.0 / 150.0;  // 0.67%/min
-    else if (ppO2 <= 1.5) return 100.0 / 120.0;  // 0.83%/min
-    else if (ppO2 <= 1.6) return 100.0 / 45.0;   // 2.22%/min
-    else return 100.0 / 6.0;                      // 16.67%/min
+    return ZHL16T_CNSRate(ppO2);
 }
 
 // Mode CCR
@@ -440,4 +1627,26 @@ void ZHL16_SwitchToBailout(ZHL16Model* model) {
             break;
         }
     }
+}
+
+// Gradient factors (en %) : le plafond est recalculé au prochain appel
+void ZHL16_SetGradientFactors(ZHL16Model* model, float gf_low, float gf_high) {
+    model->config.gf_low = gf_low;
+    model->config.gf_high = gf_high;
+    model->ceiling_state.valid = false;
+}
+
+// GF99 : part du gradient de M-value atteinte à la profondeur actuelle (%)
+float ZHL16_GetCurrentGF(ZHL16Model* model) {
+    ZHL16_GetCeiling(model);
+    return model->gf_current;
+}
+
+// Utilitaires
+float ZHL16_GetAmbientPressure(float depth, float surface_pressure) {
+    return surface_pressure + depth / 10.0;
+}
+
+float ZHL16_GetPartialPressure(float ambient_pressure, float fraction) {
+    return ambient_pressure * fraction;
 }
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include "zhl16_fixed.h"
+
+#define Q30_LN2         744261118   // ln(2) en Q2.30
+#define Q30_LN2_DIV64   11629080    // ln(2)/64 en Q2.30
+
+// 2^(-i/64) en Q2.30 (i = 0..63), en flash
+static const q30_t exp2_neg_table[64] = {
+    1073741824, 1062175491, 1050733751, 1039415261, 1028218693, 1017142735,
+    1006186087, 995347464, 984625594, 974019220, 963527098, 953147997,
+    942880699, 932724001, 922676710, 912737649, 902905651, 893179563,
+    883558244, 874040567, 864625413, 855311680, 846098274, 836984114,
+    827968132, 819049271, 810226483, 801498734, 792865000, 784324269,
+    775875538, 767517817, 759250125, 751071493, 742980960, 734977579,
+    727060411, 719228525, 711481005, 703816941, 696235434, 688735596,
+    681316545, 673977412, 666717336, 659535466, 652430958, 645402981,
+    638450708, 631573326, 624770026, 618040012, 611382493, 604796689,
+    598281827, 591837143, 585461881, 579155293, 572916640, 566745190,
+    560640218, 554601009, 548626854, 542717053
+};
+
+// ln(1 + i/64) en Q2.30 (i = 0..63), en flash
+static const q30_t log1p_table[64] = {
+    0, 16647494, 33040817, 49187615, 65095192, 80770534,
+    96220323, 111450959, 126468572, 141279038, 155887996, 170300854,
+    184522808, 198558849, 212413774, 226092199, 239598564, 252937143,
+    266112055, 279127266, 291986604, 304693756, 317252283, 329665621,
+    341937090, 354069895, 366067135, 377931807, 389666807, 401274940,
+    412758919, 424121372, 435364845, 446491803, 457504636, 468405662,
+    479197128, 489881214, 500460037, 510935650, 521310048, 531585167,
+    541762891, 551845048, 561833416, 571729724, 581535654, 591252841,
+    600882877, 610427311, 619887653, 629265371, 638561895, 647778619,
+    656916903, 665978069, 674963409, 683874180, 692711611, 701476899,
+    710171213, 718795691, 727351448, 735839570
+};
+
+// exp(-x) = 2^-n * 2^(-i/64) * exp(-d) : n et i par division par ln(2) et
+// ln(2)/64, table pour 2^(-i/64), exp(-d) (d < 0.011) par série d'ordre 3
+q30_t Q30_ExpNeg(int64_t x) {
+    if (x <= 0) return Q30_ONE;
+    
+    int64_t n = x / Q30_LN2;
+    if (n >= 31) return 0;
+    
+    int32_t r = (int32_t)(x - n * Q30_LN2);
+    int32_t i = r / Q30_LN2_DIV64;
+    if (i > 63) i = 63;
+    int64_t d = r - i * Q30_LN2_DIV64;
+    
+    // 1 - d + d²/2 - d³/6
+    int64_t d2 = (d * d) >> 30;
+    int64_t d3 = (d2 * d) >> 30;
+    int64_t series = Q30_ONE - d + d2 / 2 - d3 / 6;
+    
+    int64_t result = ((int64_t)exp2_neg_table[i] * series + (1 << 29)) >> 30;
+    if (n > 0) {
+        result = (result + ((int64_t)1 << (n - 1))) >> n;
+    }
+    
+    return (q30_t)result;
+}
+
+// ln(x) = e*ln(2) + ln(1 + i/64) + ln(1 + d) : mantisse normalisée dans [1, 2[,
+// table pour ln(1 + i/64), ln(1 + d) (d < 1/64) par série d'ordre 3
+q24_t Q24_Log(q24_t x) {
+    if (x <= 0) return INT32_MIN;
+    
+    // Normalisation : m dans [2^30, 2^31[ représente la mantisse en Q2.30
+    uint32_t m = (uint32_t)x;
+    int32_t shift = 0;
+    while (m < (1u << 30)) {
+        m <<= 1;
+        shift++;
+    }
+    int32_t e = 6 - shift;
+    
+    int32_t i = (m >> 24) & 63;
+    int64_t base = ((int64_t)1 << 30) + ((int64_t)i << 24);
+    int64_t d = (((int64_t)m - base) << 30) / base;
+    
+    // d - d²/2 + d³/3
+    int64_t d2 = (d * d) >> 30;
+    int64_t d3 = (d2 * d) >> 30;
+    int64_t result = (int64_t)e * Q30_LN2 + log1p_table[i] + d - d2 / 2 + d3 / 3;
+    
+    // Q2.30 vers Q8.24, arrondi au plus proche
+    return (q24_t)((result + 32) >> 6);
+}
\ No newline at end of file
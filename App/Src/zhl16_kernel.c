@@ -0,0 +1,667 @@
+#include "zhl16_kernel.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(ZHL16_FIXED_POINT)
+#elif defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(ZHL16_FIXED_POINT)
+// ============================================================================
+// CHEMIN VIRGULE FIXE (cibles sans FPU, voir zhl16_fixed.h)
+// ============================================================================
+
+void ZHL16K_UpdateTissues(TissueState* tissues, const DecayFactors* decay,
+                          float inspired_N2, float inspired_He) {
+    q24_t insp_N2 = Q24_FROM_FLOAT(inspired_N2);
+    q24_t insp_He = Q24_FROM_FLOAT(inspired_He);
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        tissues->pressure_N2[i] = insp_N2 + Q24_MulQ30(tissues->pressure_N2[i] - insp_N2, decay->factor_N2[i]);
+        tissues->pressure_He[i] = insp_He + Q24_MulQ30(tissues->pressure_He[i] - insp_He, decay->factor_He[i]);
+    }
+}
+
+void ZHL16K_UpdateTissuesLinear(TissueState* tissues, const DecayFactors* decay,
+                                const ZHL16Coefficients* coeffs,
+                                float inspired_N2, float inspired_He,
+                                float rate_N2, float rate_He) {
+    float time_minutes = decay->time_seconds / 60.0f;
+    q24_t insp_N2 = Q24_FROM_FLOAT(inspired_N2);
+    q24_t insp_He = Q24_FROM_FLOAT(inspired_He);
+    q24_t end_N2 = Q24_FROM_FLOAT(inspired_N2 + rate_N2 * time_minutes);
+    q24_t end_He = Q24_FROM_FLOAT(inspired_He + rate_He * time_minutes);
+    q24_t r_N2 = Q24_FROM_FLOAT(rate_N2);
+    q24_t r_He = Q24_FROM_FLOAT(rate_He);
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        q30_t f_N2 = decay->factor_N2[i];
+        q30_t f_He = decay->factor_He[i];
+        // (R/k)*(1 - f) : produit d'abord, R/k seul dépasserait ±128 bar
+        q24_t lag_N2 = (q24_t)((int64_t)r_N2 * (Q30_ONE - f_N2) / coeffs->k_N2[i]);
+        q24_t lag_He = (q24_t)((int64_t)r_He * (Q30_ONE - f_He) / coeffs->k_He[i]);
+        tissues->pressure_N2[i] = end_N2 + Q24_MulQ30(tissues->pressure_N2[i] - insp_N2, f_N2) - lag_N2;
+        tissues->pressure_He[i] = end_He + Q24_MulQ30(tissues->pressure_He[i] - insp_He, f_He) - lag_He;
+    }
+}
+
+// a et 1/b pondérés N2/He (Q16.16), 1/b par une seule division de b
+void ZHL16K_UpdateMix(TissueState* tissues, const ZHL16Coefficients* coeffs) {
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        q24_t p_N2 = tissues->pressure_N2[i];
+        q24_t p_He = tissues->pressure_He[i];
+        q24_t p_total = p_N2 + p_He;
+        if (p_total <= 0) {
+            tissues->a_mix[i] = 0;
+            tissues->inv_b_mix[i] = Q16_ONE;
+            continue;
+        }
+        
+        q16_t b = (q16_t)(((int64_t)coeffs->b_N2[i] * p_N2 + (int64_t)coeffs->b_He[i] * p_He) / p_total);
+        tissues->a_mix[i] = (q16_t)(((int64_t)coeffs->a_N2[i] * p_N2 + (int64_t)coeffs->a_He[i] * p_He) / p_total);
+        tissues->inv_b_mix[i] = (q16_t)(((int64_t)Q16_ONE << 16) / b);
+    }
+}
+
+float ZHL16K_UpdateLoading(TissueState* tissues, float ambient_pressure, uint8_t* leading) {
+    q16_t ambient = Q16_FROM_FLOAT(ambient_pressure);
+    q16_t max_loading = 0;
+    *leading = 0;
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        q24_t p_total = tissues->pressure_N2[i] + tissues->pressure_He[i];
+        if (p_total <= 0) {
+            tissues->loading[i] = 0;
+            continue;
+        }
+        
+        q16_t m_value = tissues->a_mix[i] + Q16_Mul(ambient, tissues->inv_b_mix[i]);
+        tissues->loading[i] = (q16_t)(((int64_t)p_total * 100 << 8) / m_value);
+        
+        if (tissues->loading[i] > max_loading) {
+            max_loading = tissues->loading[i];
+            *leading = i;
+        }
+    }
+    
+    return Q16_TO_FLOAT(max_loading);
+}
+
+// Pression tolérée d'un compartiment : (P - a*gf) / (gf/b - gf + 1),
+// numérateur en Q8.24, dénominateur en Q16.16
+static inline q24_t ZHL16K_Tolerated(const TissueState* tissues, int i, q24_t p_total, q16_t gf) {
+    q16_t denom = Q16_Mul(gf, tissues->inv_b_mix[i]) - gf + Q16_ONE;
+    int64_t num = p_total - (((int64_t)tissues->a_mix[i] * gf) >> 8);
+    return (q24_t)((num << 16) / denom);
+}
+
+// GF atteint (Q16.16, en %) : (P - Pamb) / (M(Pamb) - Pamb), ambiante en Q8.24
+static inline q16_t ZHL16K_GradientFactor(const TissueState* tissues, int i, q24_t p_total,
+                                          q24_t ambient) {
+    int64_t m_value = ((int64_t)tissues->a_mix[i] << 8) + (((int64_t)ambient * tissues->inv_b_mix[i]) >> 16);
+    return (q16_t)(((int64_t)(p_total - ambient) * 100 << 16) / (m_value - ambient));
+}
+
+float ZHL16K_MaxToleratedPressure(const TissueState* tissues, float gf) {
+    q16_t vgf = Q16_FROM_FLOAT(gf);
+    q24_t max_tolerated = 0;
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        q24_t p_total = tissues->pressure_N2[i] + tissues->pressure_He[i];
+        if (p_total <= 0) continue;
+        
+        q24_t p_tolerated = ZHL16K_Tolerated(tissues, i, p_total, vgf);
+        if (p_tolerated > max_tolerated) {
+            max_tolerated = p_tolerated;
+        }
+    }
+    
+    return Q24_TO_FLOAT(max_tolerated);
+}
+
+void ZHL16K_CeilingPass(const TissueState* tissues, float gf, float gf_low,
+                        float ambient_pressure, float surface_pressure, ZHL16KCeiling* out) {
+    q16_t vgf = Q16_FROM_FLOAT(gf);
+    q16_t vgf_low = Q16_FROM_FLOAT(gf_low);
+    q24_t ambient = Q24_FROM_FLOAT(ambient_pressure);
+    q24_t surface = Q24_FROM_FLOAT(surface_pressure);
+    q24_t max_tolerated = 0;
+    q24_t max_tolerated_low = 0;
+    q16_t max_gf99 = 0;
+    q16_t max_gf_surface = 0;
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        q24_t p_total = tissues->pressure_N2[i] + tissues->pressure_He[i];
+        if (p_total <= 0) continue;
+        
+        q24_t p_tolerated = ZHL16K_Tolerated(tissues, i, p_total, vgf);
+        q24_t p_tolerated_low = vgf_low == vgf ? p_tolerated : ZHL16K_Tolerated(tissues, i, p_total, vgf_low);
+        q16_t gf99 = ZHL16K_GradientFactor(tissues, i, p_total, ambient);
+        q16_t gf_surface = ZHL16K_GradientFactor(tissues, i, p_total, surface);
+        if (p_tolerated > max_tolerated) max_tolerated = p_tolerated;
+        if (p_tolerated_low > max_tolerated_low) max_tolerated_low = p_tolerated_low;
+        if (gf99 > max_gf99) max_gf99 = gf99;
+        if (gf_surface > max_gf_surface) max_gf_surface = gf_surface;
+    }
+    
+    out->tolerated = Q24_TO_FLOAT(max_tolerated);
+    out->tolerated_low = Q24_TO_FLOAT(max_tolerated_low);
+    out->gf99 = Q16_TO_FLOAT(max_gf99);
+    out->gf_surface = Q16_TO_FLOAT(max_gf_surface);
+}
+
+// La référence est le chemin entier lui-même (contrôle float : Tools/zhl16_fixed_check.c)
+void ZHL16K_UpdateTissues_Ref(TissueState* tissues, const DecayFactors* decay,
+                              float inspired_N2, float inspired_He) {
+    ZHL16K_UpdateTissues(tissues, decay, inspired_N2, inspired_He);
+}
+
+void ZHL16K_UpdateTissuesLinear_Ref(TissueState* tissues, const DecayFactors* decay,
+                                    const ZHL16Coefficients* coeffs,
+                                    float inspired_N2, float inspired_He,
+                                    float rate_N2, float rate_He) {
+    ZHL16K_UpdateTissuesLinear(tissues, decay, coeffs, inspired_N2, inspired_He, rate_N2, rate_He);
+}
+
+void ZHL16K_UpdateMix_Ref(TissueState* tissues, const ZHL16Coefficients* coeffs) {
+    ZHL16K_UpdateMix(tissues, coeffs);
+}
+
+float ZHL16K_UpdateLoading_Ref(TissueState* tissues, float ambient_pressure, uint8_t* leading) {
+    return ZHL16K_UpdateLoading(tissues, ambient_pressure, leading);
+}
+
+float ZHL16K_MaxToleratedPressure_Ref(const TissueState* tissues, float gf) {
+    return ZHL16K_MaxToleratedPressure(tissues, gf);
+}
+
+void ZHL16K_CeilingPass_Ref(const TissueState* tissues, float gf, float gf_low,
+                            float ambient_pressure, float surface_pressure, ZHL16KCeiling* out) {
+    ZHL16K_CeilingPass(tissues, gf, gf_low, ambient_pressure, surface_pressure, out);
+}
+
+#else
+// ============================================================================
+// RÉFÉRENCE SCALAIRE
+// ============================================================================
+void ZHL16K_UpdateTissues_Ref(TissueState* tissues, const DecayFactors* decay,
+                              float inspired_N2, float inspired_He) {
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        // Équation de Schreiner à pression constante
+        tissues->pressure_N2[i] = inspired_N2 + (tissues->pressure_N2[i] - inspired_N2) * decay->factor_N2[i];
+        tissues->pressure_He[i] = inspired_He + (tissues->pressure_He[i] - inspired_He) * decay->factor_He[i];
+    }
+}
+
+// Équation de Schreiner à variation linéaire de la pression inspirée
+// (rate en bar/min) : P = Pi0 + R*t + (P0 - Pi0)*f - (R/k)*(1 - f), f = exp(-k*t)
+void ZHL16K_UpdateTissuesLinear_Ref(TissueState* tissues, const DecayFactors* decay,
+                                    const ZHL16Coefficients* coeffs,
+                                    float inspired_N2, float inspired_He,
+                                    float rate_N2, float rate_He) {
+    float time_minutes = decay->time_seconds / 60.0f;
+    float end_N2 = inspired_N2 + rate_N2 * time_minutes;
+    float end_He = inspired_He + rate_He * time_minutes;
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        float f_N2 = decay->factor_N2[i];
+        float f_He = decay->factor_He[i];
+        tissues->pressure_N2[i] = end_N2 + (tissues->pressure_N2[i] - inspired_N2) * f_N2
+                                  - (rate_N2 / coeffs->k_N2[i]) * (1.0f - f_N2);
+        tissues->pressure_He[i] = end_He + (tissues->pressure_He[i] - inspired_He) * f_He
+                                  - (rate_He / coeffs->k_He[i]) * (1.0f - f_He);
+    }
+}
+
+// a et 1/b pondérés N2/He, recalculés à chaque mise à jour des pressions :
+// plafond et saturation n'ont plus qu'une division par compartiment
+void ZHL16K_UpdateMix_Ref(TissueState* tissues, const ZHL16Coefficients* coeffs) {
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        float p_N2 = tissues->pressure_N2[i];
+        float p_He = tissues->pressure_He[i];
+        float p_total = p_N2 + p_He;
+        tissues->a_mix[i] = (coeffs->a_N2[i] * p_N2 + coeffs->a_He[i] * p_He) / p_total;
+        tissues->inv_b_mix[i] = p_total / (coeffs->b_N2[i] * p_N2 + coeffs->b_He[i] * p_He);
+    }
+}
+
+float ZHL16K_UpdateLoading_Ref(TissueState* tissues, float ambient_pressure, uint8_t* leading) {
+    float max_loading = 0.0f;
+    *leading = 0;
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        float p_total = tissues->pressure_N2[i] + tissues->pressure_He[i];
+        float m_value = tissues->a_mix[i] + ambient_pressure * tissues->inv_b_mix[i];
+        tissues->loading[i] = (p_total / m_value) * 100.0f;
+        
+        if (tissues->loading[i] > max_loading) {
+            max_loading = tissues->loading[i];
+            *leading = i;
+        }
+    }
+    
+    return max_loading;
+}
+
+float ZHL16K_MaxToleratedPressure_Ref(const TissueState* tissues, float gf) {
+    float max_tolerated = 0.0f;
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        float p_total = tissues->pressure_N2[i] + tissues->pressure_He[i];
+        if (p_total <= 0) continue;
+        
+        // Pression ambiante tolérée avec GF
+        float p_tolerated = (p_total - tissues->a_mix[i] * gf) / (gf * tissues->inv_b_mix[i] - gf + 1.0f);
+        if (p_tolerated > max_tolerated) {
+            max_tolerated = p_tolerated;
+        }
+    }
+    
+    return max_tolerated;
+}
+
+// Passe plafond complète : pressions tolérées au GF appliqué et au GF bas,
+// GF atteints (P - Pamb) / (M(Pamb) - Pamb) à l'ambiante et en surface
+void ZHL16K_CeilingPass_Ref(const TissueState* tissues, float gf, float gf_low,
+                            float ambient_pressure, float surface_pressure, ZHL16KCeiling* out) {
+    out->tolerated = 0.0f;
+    out->tolerated_low = 0.0f;
+    out->gf99 = 0.0f;
+    out->gf_surface = 0.0f;
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        float p_total = tissues->pressure_N2[i] + tissues->pressure_He[i];
+        if (p_total <= 0) continue;
+        
+        float a = tissues->a_mix[i];
+        float inv_b = tissues->inv_b_mix[i];
+        float p_tolerated = (p_total - a * gf) / (gf * inv_b - gf + 1.0f);
+        float p_tolerated_low = (p_total - a * gf_low) / (gf_low * inv_b - gf_low + 1.0f);
+        float gf99 = (p_total - ambient_pressure) / (a + ambient_pressure * (inv_b - 1.0f)) * 100.0f;
+        float gf_surface = (p_total - surface_pressure) / (a + surface_pressure * (inv_b - 1.0f)) * 100.0f;
+        if (p_tolerated > out->tolerated) out->tolerated = p_tolerated;
+        if (p_tolerated_low > out->tolerated_low) out->tolerated_low = p_tolerated_low;
+        if (gf99 > out->gf99) out->gf99 = gf99;
+        if (gf_surface > out->gf_surface) out->gf_surface = gf_surface;
+    }
+}
+
+// ============================================================================
+// CHEMIN VECTORIEL HÔTE (SSE2 / AVX)
+// ============================================================================
+#if defined(__AVX__) || defined(__SSE2__)
+
+#if defined(__AVX__)
+typedef __m256 vfloat;
+#define VLANES          8
+#define VLOAD(p)        _mm256_loadu_ps(p)
+#define VSTORE(p, v)    _mm256_storeu_ps(p, v)
+#define VSET1(x)        _mm256_set1_ps(x)
+#define VADD(a, b)      _mm256_add_ps(a, b)
+#define VSUB(a, b)      _mm256_sub_ps(a, b)
+#define VMUL(a, b)      _mm256_mul_ps(a, b)
+#define VDIV(a, b)      _mm256_div_ps(a, b)
+#define VMAX(a, b)      _mm256_max_ps(a, b)
+#define VKEEP_POS(m, v) _mm256_and_ps(_mm256_cmp_ps(m, _mm256_setzero_ps(), _CMP_GT_OQ), v)
+#else
+typedef __m128 vfloat;
+#define VLANES          4
+#define VLOAD(p)        _mm_loadu_ps(p)
+#define VSTORE(p, v)    _mm_storeu_ps(p, v)
+#define VSET1(x)        _mm_set1_ps(x)
+#define VADD(a, b)      _mm_add_ps(a, b)
+#define VSUB(a, b)      _mm_sub_ps(a, b)
+#define VMUL(a, b)      _mm_mul_ps(a, b)
+#define VDIV(a, b)      _mm_div_ps(a, b)
+#define VMAX(a, b)      _mm_max_ps(a, b)
+#define VKEEP_POS(m, v) _mm_and_ps(_mm_cmpgt_ps(m, _mm_setzero_ps()), v)
+#endif
+
+void ZHL16K_UpdateTissues(TissueState* tissues, const DecayFactors* decay,
+                          float inspired_N2, float inspired_He) {
+    vfloat insp_N2 = VSET1(inspired_N2);
+    vfloat insp_He = VSET1(inspired_He);
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i += VLANES) {
+        vfloat p_N2 = VLOAD(&tissues->pressure_N2[i]);
+        vfloat p_He = VLOAD(&tissues->pressure_He[i]);
+        p_N2 = VADD(insp_N2, VMUL(VSUB(p_N2, insp_N2), VLOAD(&decay->factor_N2[i])));
+        p_He = VADD(insp_He, VMUL(VSUB(p_He, insp_He), VLOAD(&decay->factor_He[i])));
+        VSTORE(&tissues->pressure_N2[i], p_N2);
+        VSTORE(&tissues->pressure_He[i], p_He);
+    }
+}
+
+void ZHL16K_UpdateTissuesLinear(TissueState* tissues, const DecayFactors* decay,
+                                const ZHL16Coefficients* coeffs,
+                                float inspired_N2, float inspired_He,
+                                float rate_N2, float rate_He) {
+    float time_minutes = decay->time_seconds / 60.0f;
+    vfloat one = VSET1(1.0f);
+    vfloat insp_N2 = VSET1(inspired_N2);
+    vfloat insp_He = VSET1(inspired_He);
+    vfloat end_N2 = VSET1(inspired_N2 + rate_N2 * time_minutes);
+    vfloat end_He = VSET1(inspired_He + rate_He * time_minutes);
+    vfloat r_N2 = VSET1(rate_N2);
+    vfloat r_He = VSET1(rate_He);
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i += VLANES) {
+        vfloat f_N2 = VLOAD(&decay->factor_N2[i]);
+        vfloat f_He = VLOAD(&decay->factor_He[i]);
+        vfloat p_N2 = VADD(end_N2, VMUL(VSUB(VLOAD(&tissues->pressure_N2[i]), insp_N2), f_N2));
+        vfloat p_He = VADD(end_He, VMUL(VSUB(VLOAD(&tissues->pressure_He[i]), insp_He), f_He));
+        p_N2 = VSUB(p_N2, VMUL(VDIV(r_N2, VLOAD(&coeffs->k_N2[i])), VSUB(one, f_N2)));
+        p_He = VSUB(p_He, VMUL(VDIV(r_He, VLOAD(&coeffs->k_He[i])), VSUB(one, f_He)));
+        VSTORE(&tissues->pressure_N2[i], p_N2);
+        VSTORE(&tissues->pressure_He[i], p_He);
+    }
+}
+
+void ZHL16K_UpdateMix(TissueState* tissues, const ZHL16Coefficients* coeffs) {
+    for (int i = 0; i < NUM_COMPARTMENTS; i += VLANES) {
+        vfloat p_N2 = VLOAD(&tissues->pressure_N2[i]);
+        vfloat p_He = VLOAD(&tissues->pressure_He[i]);
+        vfloat p_total = VADD(p_N2, p_He);
+        vfloat a = VADD(VMUL(VLOAD(&coeffs->a_N2[i]), p_N2), VMUL(VLOAD(&coeffs->a_He[i]), p_He));
+        vfloat b = VADD(VMUL(VLOAD(&coeffs->b_N2[i]), p_N2), VMUL(VLOAD(&coeffs->b_He[i]), p_He));
+        VSTORE(&tissues->a_mix[i], VDIV(a, p_total));
+        VSTORE(&tissues->inv_b_mix[i], VDIV(p_total, b));
+    }
+}
+
+float ZHL16K_UpdateLoading(TissueState* tissues, float ambient_pressure, uint8_t* leading) {
+    vfloat ambient = VSET1(ambient_pressure);
+    vfloat hundred = VSET1(100.0f);
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i += VLANES) {
+        vfloat p_total = VADD(VLOAD(&tissues->pressure_N2[i]), VLOAD(&tissues->pressure_He[i]));
+        vfloat m_value = VADD(VLOAD(&tissues->a_mix[i]), VMUL(ambient, VLOAD(&tissues->inv_b_mix[i])));
+        VSTORE(&tissues->loading[i], VMUL(VDIV(p_total, m_value), hundred));
+    }
+    
+    // Réduction argmax (16 comparaisons, même ordre que la référence)
+    float max_loading = 0.0f;
+    *leading = 0;
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        if (tissues->loading[i] > max_loading) {
+            max_loading = tissues->loading[i];
+            *leading = i;
+        }
+    }
+    
+    return max_loading;
+}
+
+// Maximum des voies d'un accumulateur
+static inline float ZHL16K_ReduceMax(vfloat acc) {
+    float lanes[VLANES];
+    VSTORE(lanes, acc);
+    float max_value = lanes[0];
+    for (int i = 1; i < VLANES; i++) {
+        if (lanes[i] > max_value) max_value = lanes[i];
+    }
+    return max_value;
+}
+
+float ZHL16K_MaxToleratedPressure(const TissueState* tissues, float gf) {
+    vfloat denom_offset = VSET1(1.0f - gf);
+    vfloat vgf = VSET1(gf);
+    vfloat acc = VSET1(0.0f);
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i += VLANES) {
+        vfloat p_total = VADD(VLOAD(&tissues->pressure_N2[i]), VLOAD(&tissues->pressure_He[i]));
+        vfloat p_tolerated = VDIV(VSUB(p_total, VMUL(VLOAD(&tissues->a_mix[i]), vgf)),
+                                  VADD(VMUL(VLOAD(&tissues->inv_b_mix[i]), vgf), denom_offset));
+        
+        // Compartiments vides (p_total <= 0) ignorés
+        acc = VMAX(acc, VKEEP_POS(p_total, p_tolerated));
+    }
+    
+    return ZHL16K_ReduceMax(acc);
+}
+
+void ZHL16K_CeilingPass(const TissueState* tissues, float gf, float gf_low,
+                        float ambient_pressure, float surface_pressure, ZHL16KCeiling* out) {
+    vfloat one = VSET1(1.0f);
+    vfloat vgf = VSET1(gf);
+    vfloat vgf_low = VSET1(gf_low);
+    vfloat denom_offset = VSET1(1.0f - gf);
+    vfloat denom_offset_low = VSET1(1.0f - gf_low);
+    vfloat ambient = VSET1(ambient_pressure);
+    vfloat surface = VSET1(surface_pressure);
+    vfloat hundred = VSET1(100.0f);
+    vfloat acc_tolerated = VSET1(0.0f);
+    vfloat acc_low = VSET1(0.0f);
+    vfloat acc_gf99 = VSET1(0.0f);
+    vfloat acc_surface = VSET1(0.0f);
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i += VLANES) {
+        vfloat p_total = VADD(VLOAD(&tissues->pressure_N2[i]), VLOAD(&tissues->pressure_He[i]));
+        vfloat a = VLOAD(&tissues->a_mix[i]);
+        vfloat inv_b = VLOAD(&tissues->inv_b_mix[i]);
+        vfloat inv_b_minus_one = VSUB(inv_b, one);
+        vfloat p_tolerated = VDIV(VSUB(p_total, VMUL(a, vgf)), VADD(VMUL(inv_b, vgf), denom_offset));
+        vfloat p_tolerated_low = VDIV(VSUB(p_total, VMUL(a, vgf_low)), VADD(VMUL(inv_b, vgf_low), denom_offset_low));
+        vfloat gf99 = VDIV(VSUB(p_total, ambient), VADD(a, VMUL(ambient, inv_b_minus_one)));
+        vfloat gf_surface = VDIV(VSUB(p_total, surface), VADD(a, VMUL(surface, inv_b_minus_one)));
+        
+        acc_tolerated = VMAX(acc_tolerated, VKEEP_POS(p_total, p_tolerated));
+        acc_low = VMAX(acc_low, VKEEP_POS(p_total, p_tolerated_low));
+        acc_gf99 = VMAX(acc_gf99, VKEEP_POS(p_total, gf99));
+        acc_surface = VMAX(acc_surface, VKEEP_POS(p_total, gf_surface));
+    }
+    
+    out->tolerated = ZHL16K_ReduceMax(acc_tolerated);
+    out->tolerated_low = ZHL16K_ReduceMax(acc_low);
+    out->gf99 = ZHL16K_ReduceMax(VMUL(acc_gf99, hundred));
+    out->gf_surface = ZHL16K_ReduceMax(VMUL(acc_surface, hundred));
+}
+
+// ============================================================================
+// CHEMIN CORTEX-M4 (FPU simple précision, VFMA)
+// ============================================================================
+#elif defined(__ARM_FP) && defined(__ARM_FEATURE_FMA)
+
+void ZHL16K_UpdateTissues(TissueState* tissues, const DecayFactors* decay,
+                          float inspired_N2, float inspired_He) {
+    // Déroulé par 4 pour remplir le pipeline FPU, une VFMA par gaz
+    for (int i = 0; i < NUM_COMPARTMENTS; i += 4) {
+        for (int j = i; j < i + 4; j++) {
+            tissues->pressure_N2[j] = fmaf(tissues->pressure_N2[j] - inspired_N2, decay->factor_N2[j], inspired_N2);
+            tissues->pressure_He[j] = fmaf(tissues->pressure_He[j] - inspired_He, decay->factor_He[j], inspired_He);
+        }
+    }
+}
+
+void ZHL16K_UpdateTissuesLinear(TissueState* tissues, const DecayFactors* decay,
+                                const ZHL16Coefficients* coeffs,
+                                float inspired_N2, float inspired_He,
+                                float rate_N2, float rate_He) {
+    float time_minutes = decay->time_seconds / 60.0f;
+    float end_N2 = fmaf(rate_N2, time_minutes, inspired_N2);
+    float end_He = fmaf(rate_He, time_minutes, inspired_He);
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        float f_N2 = decay->factor_N2[i];
+        float f_He = decay->factor_He[i];
+        float p_N2 = fmaf(tissues->pressure_N2[i] - inspired_N2, f_N2, end_N2);
+        float p_He = fmaf(tissues->pressure_He[i] - inspired_He, f_He, end_He);
+        tissues->pressure_N2[i] = fmaf(-(rate_N2 / coeffs->k_N2[i]), 1.0f - f_N2, p_N2);
+        tissues->pressure_He[i] = fmaf(-(rate_He / coeffs->k_He[i]), 1.0f - f_He, p_He);
+    }
+}
+
+void ZHL16K_UpdateMix(TissueState* tissues, const ZHL16Coefficients* coeffs) {
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        float p_N2 = tissues->pressure_N2[i];
+        float p_He = tissues->pressure_He[i];
+        float p_total = p_N2 + p_He;
+        tissues->a_mix[i] = fmaf(coeffs->a_N2[i], p_N2, coeffs->a_He[i] * p_He) / p_total;
+        tissues->inv_b_mix[i] = p_total / fmaf(coeffs->b_N2[i], p_N2, coeffs->b_He[i] * p_He);
+    }
+}
+
+float ZHL16K_UpdateLoading(TissueState* tissues, float ambient_pressure, uint8_t* leading) {
+    float max_loading = 0.0f;
+    *leading = 0;
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        float p_total = tissues->pressure_N2[i] + tissues->pressure_He[i];
+        float m_value = fmaf(ambient_pressure, tissues->inv_b_mix[i], tissues->a_mix[i]);
+        tissues->loading[i] = (p_total / m_value) * 100.0f;
+        
+        if (tissues->loading[i] > max_loading) {
+            max_loading = tissues->loading[i];
+            *leading = i;
+        }
+    }
+    
+    return max_loading;
+}
+
+float ZHL16K_MaxToleratedPressure(const TissueState* tissues, float gf) {
+    float one_minus_gf = 1.0f - gf;
+    float max_tolerated = 0.0f;
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        float p_total = tissues->pressure_N2[i] + tissues->pressure_He[i];
+        if (p_total <= 0) continue;
+        
+        float p_tolerated = fmaf(-tissues->a_mix[i], gf, p_total) / fmaf(gf, tissues->inv_b_mix[i], one_minus_gf);
+        if (p_tolerated > max_tolerated) {
+            max_tolerated = p_tolerated;
+        }
+    }
+    
+    return max_tolerated;
+}
+
+void ZHL16K_CeilingPass(const TissueState* tissues, float gf, float gf_low,
+                        float ambient_pressure, float surface_pressure, ZHL16KCeiling* out) {
+    float one_minus_gf = 1.0f - gf;
+    float one_minus_gf_low = 1.0f - gf_low;
+    out->tolerated = 0.0f;
+    out->tolerated_low = 0.0f;
+    out->gf99 = 0.0f;
+    out->gf_surface = 0.0f;
+    
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        float p_total = tissues->pressure_N2[i] + tissues->pressure_He[i];
+        if (p_total <= 0) continue;
+        
+        float a = tissues->a_mix[i];
+        float inv_b_minus_one = tissues->inv_b_mix[i] - 1.0f;
+        float p_tolerated = fmaf(-a, gf, p_total) / fmaf(gf, tissues->inv_b_mix[i], one_minus_gf);
+        float p_tolerated_low = fmaf(-a, gf_low, p_total) / fmaf(gf_low, tissues->inv_b_mix[i], one_minus_gf_low);
+        float gf99 = (p_total - ambient_pressure) / fmaf(ambient_pressure, inv_b_minus_one, a);
+        float gf_surface = (p_total - surface_pressure) / fmaf(surface_pressure, inv_b_minus_one, a);
+        if (p_tolerated > out->tolerated) out->tolerated = p_tolerated;
+        if (p_tolerated_low > out->tolerated_low) out->tolerated_low = p_tolerated_low;
+        if (gf99 > out->gf99) out->gf99 = gf99;
+        if (gf_surface > out->gf_surface) out->gf_surface = gf_surface;
+    }
+    
+    out->gf99 *= 100.0f;
+    out->gf_surface *= 100.0f;
+}
+
+// ============================================================================
+// CIBLE SANS CHEMIN SPÉCIFIQUE
+// ============================================================================
+#else
+
+void ZHL16K_UpdateTissues(TissueState* tissues, const DecayFactors* decay,
+                          float inspired_N2, float inspired_He) {
+    ZHL16K_UpdateTissues_Ref(tissues, decay, inspired_N2, inspired_He);
+}
+
+void ZHL16K_UpdateTissuesLinear(TissueState* tissues, const DecayFactors* decay,
+                                const ZHL16Coefficients* coeffs,
+                                float inspired_N2, float inspired_He,
+                                float rate_N2, float rate_He) {
+    ZHL16K_UpdateTissuesLinear_Ref(tissues, decay, coeffs, inspired_N2, inspired_He, rate_N2, rate_He);
+}
+
+void ZHL16K_UpdateMix(TissueState* tissues, const ZHL16Coefficients* coeffs) {
+    ZHL16K_UpdateMix_Ref(tissues, coeffs);
+}
+
+float ZHL16K_UpdateLoading(TissueState* tissues, float ambient_pressure, uint8_t* leading) {
+    return ZHL16K_UpdateLoading_Ref(tissues, ambient_pressure, leading);
+}
+
+float ZHL16K_MaxToleratedPressure(const TissueState* tissues, float gf) {
+    return ZHL16K_MaxToleratedPressure_Ref(tissues, gf);
+}
+
+void ZHL16K_CeilingPass(const TissueState* tissues, float gf, float gf_low,
+                        float ambient_pressure, float surface_pressure, ZHL16KCeiling* out) {
+    ZHL16K_CeilingPass_Ref(tissues, gf, gf_low, ambient_pressure, surface_pressure, out);
+}
+
+#endif
+
+#endif
+
+// ============================================================================
+// AUTO-TEST
+// ============================================================================
+static bool ZHL16K_Close(float value, float reference, float tolerance) {
+    float scale = fabsf(reference) > 1.0f ? fabsf(reference) : 1.0f;
+    return fabsf(value - reference) <= tolerance * scale;
+}
+
+bool ZHL16K_SelfTest(const ZHL16Coefficients* coeffs, float tolerance) {
+    TissueState vec, ref;
+    DecayFactors decay;
+    uint32_t seed = 0x2545F491;
+    
+    // État pseudo-aléatoire reproductible : N2 0.5-8 bar, He 0-6 bar
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        ref.pressure_N2[i] = ZHL16_PRESSURE(0.5f + (seed >> 8) * (7.5f / 16777216.0f));
+        seed = seed * 1664525u + 1013904223u;
+        ref.pressure_He[i] = ZHL16_PRESSURE((seed >> 8) * (6.0f / 16777216.0f));
+        decay.factor_N2[i] = ZHL16_FRACTION(expf(-ZHL16_FRACTION_F(coeffs->k_N2[i]) * 0.75f));
+        decay.factor_He[i] = ZHL16_FRACTION(expf(-ZHL16_FRACTION_F(coeffs->k_He[i]) * 0.75f));
+    }
+    memcpy(&vec, &ref, sizeof(TissueState));
+    
+    decay.time_seconds = 45.0f;
+    ZHL16K_UpdateTissues(&vec, &decay, 3.2f, 1.1f);
+    ZHL16K_UpdateTissues_Ref(&ref, &decay, 3.2f, 1.1f);
+    ZHL16K_UpdateTissuesLinear(&vec, &decay, coeffs, 3.2f, 1.1f, -0.79f, -0.12f);
+    ZHL16K_UpdateTissuesLinear_Ref(&ref, &decay, coeffs, 3.2f, 1.1f, -0.79f, -0.12f);
+    
+    ZHL16K_UpdateMix(&vec, coeffs);
+    ZHL16K_UpdateMix_Ref(&ref, coeffs);
+    
+    uint8_t leading_vec, leading_ref;
+    float max_vec = ZHL16K_UpdateLoading(&vec, 4.0f, &leading_vec);
+    float max_ref = ZHL16K_UpdateLoading_Ref(&ref, 4.0f, &leading_ref);
+    
+    bool ok = ZHL16K_Close(max_vec, max_ref, tolerance);
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        ok = ok && ZHL16K_Close(ZHL16_PRESSURE_F(vec.pressure_N2[i]), ZHL16_PRESSURE_F(ref.pressure_N2[i]), tolerance);
+        ok = ok && ZHL16K_Close(ZHL16_PRESSURE_F(vec.pressure_He[i]), ZHL16_PRESSURE_F(ref.pressure_He[i]), tolerance);
+        ok = ok && ZHL16K_Close(ZHL16_REAL_F(vec.loading[i]), ZHL16_REAL_F(ref.loading[i]), tolerance);
+    }
+    
+    for (float gf = 0.3f; gf <= 1.0f; gf += 0.35f) {
+        ok = ok && ZHL16K_Close(ZHL16K_MaxToleratedPressure(&vec, gf),
+                                ZHL16K_MaxToleratedPressure_Ref(&ref, gf), tolerance);
+    }
+    
+    ZHL16KCeiling pass_vec, pass_ref;
+    ZHL16K_CeilingPass(&vec, 0.55f, 0.3f, 4.0f, 1.013f, &pass_vec);
+    ZHL16K_CeilingPass_Ref(&ref, 0.55f, 0.3f, 4.0f, 1.013f, &pass_ref);
+    ok = ok && ZHL16K_Close(pass_vec.tolerated, pass_ref.tolerated, tolerance);
+    ok = ok && ZHL16K_Close(pass_vec.tolerated_low, pass_ref.tolerated_low, tolerance);
+    ok = ok && ZHL16K_Close(pass_vec.gf99, pass_ref.gf99, tolerance);
+    ok = ok && ZHL16K_Close(pass_vec.gf_surface, pass_ref.gf_surface, tolerance);
+    
+    return ok;
+}
@@ -0,0 +1,50 @@
+#include "zhl16_tox.h"
+#include <math.h>
+
+// Limites d'exposition NOAA (minutes) converties en %/min, un point tous les
+// 0.1 bar de 0.5 à 1.7 bar (au-delà de 1.6 bar : 6 min). Dernière valeur
+// dupliquée : l'interpolation lit toujours deux points sans test.
+static const float cns_rate_table[CNS_TABLE_POINTS + 1] = {
+    0.0f,            100.0f / 720.0f, 100.0f / 570.0f, 100.0f / 450.0f,
+    100.0f / 360.0f, 100.0f / 300.0f, 100.0f / 240.0f, 100.0f / 210.0f,
+    100.0f / 180.0f, 100.0f / 150.0f, 100.0f / 120.0f, 100.0f / 45.0f,
+    100.0f / 6.0f,   100.0f / 6.0f
+};
+
+// ((ppO2 - 0.5) / 0.5)^0.83 tous les 0.05 bar de 0.5 à 2.5 bar
+static const float otu_rate_table[OTU_TABLE_POINTS + 1] = {
+    0.0000f, 0.1479f, 0.2629f, 0.3681f, 0.4674f, 0.5625f, 0.6544f, 0.7438f,
+    0.8309f, 0.9163f, 1.0000f, 1.0823f, 1.1634f, 1.2433f, 1.3222f, 1.4001f,
+    1.4771f, 1.5534f, 1.6288f, 1.7036f, 1.7777f, 1.8512f, 1.9240f, 1.9963f,
+    2.0681f, 2.1394f, 2.2102f, 2.2805f, 2.3504f, 2.4199f, 2.4889f, 2.5576f,
+    2.6259f, 2.6938f, 2.7614f, 2.8286f, 2.8956f, 2.9622f, 3.0284f, 3.0945f,
+    3.1602f, 3.1602f
+};
+
+// Interpolation linéaire, position en pas de table bornée à [0, dernier point]
+// (fminf/fmaxf : VMIN/VMAX ou sélection conditionnelle, pas de saut)
+static inline float ZHL16T_Interpolate(const float* table, float position, float last) {
+    position = fminf(fmaxf(position, 0.0f), last);
+    int idx = (int)position;
+    float frac = position - idx;
+    
+    return table[idx] + (table[idx + 1] - table[idx]) * frac;
+}
+
+float ZHL16T_CNSRate(float ppO2) {
+    return ZHL16T_Interpolate(cns_rate_table, (ppO2 - TOX_PPO2_MIN) * (1.0f / CNS_TABLE_STEP),
+                              CNS_TABLE_POINTS - 1);
+}
+
+float ZHL16T_OTURate(float ppO2) {
+    return ZHL16T_Interpolate(otu_rate_table, (ppO2 - TOX_PPO2_MIN) * (1.0f / OTU_TABLE_STEP),
+                              OTU_TABLE_POINTS - 1);
+}
+
+float ZHL16T_CNSDecay(float seconds) {
+    return expf(-0.693147f * seconds / (CNS_HALF_TIME_MIN * 60.0f));
+}
+
+float ZHL16T_OTUDecay(float seconds) {
+    return expf(-0.693147f * seconds / (OTU_HALF_TIME_MIN * 60.0f));
+}
\ No newline at end of file
@@ -0,0 +1,315 @@
+// Simulateur de flotte : milliers de DiveComputer indépendants sur un pool de threads
+//
+// Chaque instance rejoue un profil enregistré à travers la boucle firmware
+// (DiveComputer_RunOnce : mise à jour, tâches 10 Hz et 1 Hz, calculs de fond) sous le HAL
+// virtuel de Tools/host. Un thread réutilise la même structure d'une instance
+// à l'autre (DiveComputer_Init doit tout remettre à zéro) ; toutes les
+// instances d'un même profil doivent donner des résultats identiques.
+//
+// Compilation (depuis la racine du dépôt) :
+//   gcc -O2 -std=c11 -pthread -DHOST_SIMULATION -IApp/Inc -ITools/host Tools/dc_fleet.c Tools/host/host_hal.c App/Src/dive_computer.c App/Src/dive_manager.c App/Src/dive_log.c App/Src/dive_codec.c App/Src/dive_store.c App/Src/ccr_manager.c App/Src/zhl16_core.c App/Src/zhl16_kernel.c App/Src/zhl16_fixed.c App/Src/zhl16_tox.c -lm -o dc_fleet
+//
+// Usage : ./dc_fleet [-n instances] [-t threads] [-u période_ms] [profil.csv ...]
+//   Profils : lignes "secondes,profondeur[,température]" (# : commentaire),
+//   profils intégrés si aucun fichier. Instances réparties sur les profils.
+//
+// Sortie CSV sur stdout, une ligne par profil (empreinte : hachage de la
+// chronologie plafond/TTS/NDL/phase/alarmes, seconde par seconde) ; débit sur stderr.
+// Code de retour 1 si deux instances d'un même profil divergent.
+#define _POSIX_C_SOURCE 200809L
+
+#include "host_hal.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FLEET_MAX_PROFILES      64
+#define FLEET_MAX_POINTS        20000
+#define FLEET_SURFACE_MBAR      1013.0f
+#define FLEET_TAIL_S            (DIVE_END_TIME + 60)    // Surface après le profil (fin détectée)
+
+// Profil rejoué : points interpolés linéairement
+typedef struct {
+    char name[64];
+    float* time;
+    float* depth;
+    float* temperature;
+    uint32_t num_points;
+} FleetProfile;
+
+// Résultat d'une instance (comparé octet par octet entre instances)
+typedef struct {
+    uint32_t dives_saved;
+    uint32_t duration;
+    uint32_t samples;
+    uint16_t max_tts;
+    uint8_t missed_deco_stops;
+    float max_depth;
+    float max_ceiling;
+    float cns;
+    float otu;
+    float desat_time;
+    float nofly_time;
+    uint64_t hash;
+} FleetResult;
+
+typedef struct {
+    const FleetProfile* profiles;
+    uint32_t num_profiles;
+    FleetResult* results;
+    uint32_t num_instances;
+    uint32_t update_ms;
+    atomic_uint next;
+} Fleet;
+
+// Profils
+// ----------------------------------------------------------------------------
+
+static void Fleet_AddPoint(FleetProfile* profile, float time, float depth, float temperature) {
+    if (profile->num_points >= FLEET_MAX_POINTS) return;
+    profile->time[profile->num_points] = time;
+    profile->depth[profile->num_points] = depth;
+    profile->temperature[profile->num_points] = temperature;
+    profile->num_points++;
+}
+
+static void Fleet_AllocProfile(FleetProfile* profile, const char* name) {
+    memset(profile, 0, sizeof(FleetProfile));
+    snprintf(profile->name, sizeof(profile->name), "%s", name);
+    profile->time = malloc(sizeof(float) * FLEET_MAX_POINTS);
+    profile->depth = malloc(sizeof(float) * FLEET_MAX_POINTS);
+    profile->temperature = malloc(sizeof(float) * FLEET_MAX_POINTS);
+}
+
+static bool Fleet_LoadProfile(FleetProfile* profile, const char* path) {
+    FILE* file = fopen(path, "r");
+    char line[256];
+    if (!file) return false;
+    
+    const char* name = strrchr(path, '/');
+    Fleet_AllocProfile(profile, name ? name + 1 : path);
+    while (fgets(line, sizeof(line), file)) {
+        float time, depth, temperature = 20.0f;
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%f,%f,%f", &time, &depth, &temperature) < 2) continue;
+        Fleet_AddPoint(profile, time, depth, temperature);
+    }
+    fclose(file);
+    return profile->num_points >= 2;
+}
+
+// Profils intégrés : (profondeur, minutes de séjour), vitesses 18 m/min en
+// descente et 9 m/min en remontée
+static void Fleet_BuiltinProfile(FleetProfile* profile, const char* name, const float* levels,
+                                 uint8_t num_levels) {
+    float time = 0;
+    float depth = 0;
+    
+    Fleet_AllocProfile(profile, name);
+    Fleet_AddPoint(profile, 0, 0, 20.0f);
+    for (uint8_t l = 0; l < num_levels; l++) {
+        float target = levels[2 * l];
+        float rate = target > depth ? 18.0f : 9.0f;
+        time += fabsf(target - depth) / rate * 60.0f;
+        Fleet_AddPoint(profile, time, target, 14.0f);
+        time += levels[2 * l + 1] * 60.0f;
+        Fleet_AddPoint(profile, time, target, 14.0f);
+        depth = target;
+    }
+    time += depth / 9.0f * 60.0f;
+    Fleet_AddPoint(profile, time, 0, 20.0f);
+}
+
+static uint32_t Fleet_BuiltinProfiles(FleetProfile* profiles) {
+    static const float recreational[] = { 18, 45, 5, 3 };
+    static const float deco[] = { 40, 25, 9, 2, 6, 5, 3, 12 };
+    static const float multilevel[] = { 30, 15, 20, 15, 12, 15, 5, 3 };
+    
+    Fleet_BuiltinProfile(&profiles[0], "builtin_18m", recreational, 2);
+    Fleet_BuiltinProfile(&profiles[1], "builtin_deco40m", deco, 4);
+    Fleet_BuiltinProfile(&profiles[2], "builtin_multilevel", multilevel, 4);
+    return 3;
+}
+
+// Interpolation au temps t (secondes), maintien du dernier point ensuite
+static void Fleet_Sample(const FleetProfile* profile, uint32_t* cursor, float t,
+                         float* depth, float* temperature) {
+    uint32_t i = *cursor;
+    while (i + 1 < profile->num_points && profile->time[i + 1] <= t) i++;
+    *cursor = i;
+    
+    if (i + 1 >= profile->num_points) {
+        *depth = profile->depth[i];
+        *temperature = profile->temperature[i];
+        return;
+    }
+    float span = profile->time[i + 1] - profile->time[i];
+    float w = span > 0 ? (t - profile->time[i]) / span : 0;
+    *depth = profile->depth[i] + w * (profile->depth[i + 1] - profile->depth[i]);
+    *temperature = profile->temperature[i] + w * (profile->temperature[i + 1] - profile->temperature[i]);
+}
+
+// Simulation
+// ----------------------------------------------------------------------------
+
+static uint64_t Fleet_Hash(uint64_t hash, int32_t value) {
+    hash ^= (uint32_t)value;
+    return hash * 0x100000001b3ULL;
+}
+
+// Une instance : passages de la boucle principale du firmware au pas update_ms
+static void Fleet_RunInstance(const FleetProfile* profile, uint32_t update_ms, DiveComputer* dc,
+                              HostDevice* dev, FleetResult* result) {
+    uint32_t cursor = 0;
+    float depth, temperature;
+    
+    HostHAL_Init(dev, FLEET_SURFACE_MBAR);
+    HostHAL_Bind(dev);
+    DiveComputer_Init(dc);
+    memset(result, 0, sizeof(FleetResult));
+    result->hash = 0xcbf29ce484222325ULL;
+    
+    uint32_t boot = dev->tick_ms;
+    uint32_t end = boot + (uint32_t)((profile->time[profile->num_points - 1] + FLEET_TAIL_S) * 1000.0f);
+    uint32_t second = dc->last_second;
+    
+    for (uint32_t now = boot; now <= end; now += update_ms) {
+        dev->tick_ms = now;
+        Fleet_Sample(profile, &cursor, (now - boot) / 1000.0f, &depth, &temperature);
+        dev->pressure_mbar = HostHAL_DepthToMbar(dc, depth);
+        dev->temperature_c = temperature;
+        
+        DiveComputer_RunOnce(dc);
+        if (dc->last_second == second) continue;
+        second = dc->last_second;
+        
+        // Chronologie seconde par seconde (après les tâches 1 Hz)
+        const ZHL16Model* model = &dc->zhl16;
+        uint16_t tts = model->ceiling > 0 ? model->ascend_plan.tts : 0;
+        if (model->ceiling > result->max_ceiling) result->max_ceiling = model->ceiling;
+        if (tts > result->max_tts) result->max_tts = tts;
+        result->hash = Fleet_Hash(result->hash, (int32_t)(model->ceiling * 100.0f));
+        result->hash = Fleet_Hash(result->hash, tts);
+        result->hash = Fleet_Hash(result->hash, (int32_t)(model->ndl * 10.0f));
+        result->hash = Fleet_Hash(result->hash, dc->dive.phase);
+        result->hash = Fleet_Hash(result->hash, dc->dive.ascent_rate_alarm |
+                                                dc->dive.deco_ceiling_alarm << 1);
+    }
+    
+    result->dives_saved = dc->dive.store.last_dive;
+    result->duration = dc->dive.current_dive.duration;
+    result->samples = dc->dive.current_dive.num_samples;
+    result->missed_deco_stops = dc->dive.missed_deco_stops;
+    result->max_depth = dc->dive.current_dive.max_depth;
+    result->cns = dc->zhl16.cns;
+    result->otu = dc->zhl16.otu;
+    result->desat_time = dc->zhl16.desat_time;
+    result->nofly_time = dc->zhl16.nofly_time;
+    HostHAL_Bind(NULL);
+}
+
+// Thread du pool : instances prises une à une, structures réutilisées
+static void* Fleet_Worker(void* arg) {
+    Fleet* fleet = arg;
+    DiveComputer* dc = malloc(sizeof(DiveComputer));
+    HostDevice* dev = malloc(sizeof(HostDevice));
+    
+    for (;;) {
+        uint32_t i = atomic_fetch_add(&fleet->next, 1);
+        if (i >= fleet->num_instances) break;
+        Fleet_RunInstance(&fleet->profiles[i % fleet->num_profiles], fleet->update_ms, dc, dev,
+                          &fleet->results[i]);
+    }
+    
+    free(dev);
+    free(dc);
+    return NULL;
+}
+
+static double Fleet_NowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+int main(int argc, char** argv) {
+    static FleetProfile profiles[FLEET_MAX_PROFILES];
+    uint32_t num_profiles = 0;
+    uint32_t num_instances = 1000;
+    int threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t update_ms = 100;
+    int opt;
+    
+    while ((opt = getopt(argc, argv, "n:t:u:")) != -1) {
+        switch (opt) {
+            case 'n': num_instances = (uint32_t)atoi(optarg); break;
+            case 't': threads = atoi(optarg); break;
+            case 'u': update_ms = (uint32_t)atoi(optarg); break;
+            default:
+                fprintf(stderr, "Usage : %s [-n instances] [-t threads] [-u période_ms] [profil.csv ...]\n",
+                        argv[0]);
+                return 2;
+        }
+    }
+    for (int a = optind; a < argc && num_profiles < FLEET_MAX_PROFILES; a++) {
+        if (!Fleet_LoadProfile(&profiles[num_profiles], argv[a])) {
+            fprintf(stderr, "Profil illisible : %s\n", argv[a]);
+            return 2;
+        }
+        num_profiles++;
+    }
+    if (num_profiles == 0) num_profiles = Fleet_BuiltinProfiles(profiles);
+    if (threads < 1) threads = 1;
+    if (update_ms < 1 || update_ms > 1000) update_ms = 100;
+    if (num_instances < num_profiles) num_instances = num_profiles;
+    
+    Fleet fleet = {
+        .profiles = profiles,
+        .num_profiles = num_profiles,
+        .results = calloc(num_instances, sizeof(FleetResult)),
+        .num_instances = num_instances,
+        .update_ms = update_ms,
+    };
+    atomic_init(&fleet.next, 0);
+    
+    double start = Fleet_NowMs();
+    pthread_t* ids = malloc(sizeof(pthread_t) * threads);
+    for (int t = 0; t < threads; t++) {
+        pthread_create(&ids[t], NULL, Fleet_Worker, &fleet);
+    }
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+    }
+    double elapsed = Fleet_NowMs() - start;
+    
+    // Résultats par profil et divergences entre instances
+    uint32_t mismatches = 0;
+    double simulated_s = 0;
+    printf("profile,instances,max_depth,duration_s,max_ceiling,max_tts,cns,otu,desat_min,nofly_min,"
+           "missed_deco,samples,hash,mismatches\n");
+    for (uint32_t p = 0; p < num_profiles; p++) {
+        const FleetResult* ref = &fleet.results[p];
+        uint32_t count = 0;
+        uint32_t diff = 0;
+        for (uint32_t i = p; i < num_instances; i += num_profiles) {
+            count++;
+            if (memcmp(&fleet.results[i], ref, sizeof(FleetResult)) != 0) diff++;
+        }
+        simulated_s += count * (profiles[p].time[profiles[p].num_points - 1] + FLEET_TAIL_S);
+        mismatches += diff;
+        printf("%s,%u,%.1f,%u,%.1f,%u,%.1f,%.1f,%.0f,%.0f,%u,%u,%016llx,%u\n", profiles[p].name, count,
+               ref->max_depth, ref->duration, ref->max_ceiling, ref->max_tts, ref->cns, ref->otu,
+               ref->desat_time, ref->nofly_time, ref->missed_deco_stops, ref->samples,
+               (unsigned long long)ref->hash, diff);
+    }
+    fprintf(stderr, "flotte : %u instances, %d threads, %.1f h simulées en %.0f ms (x%.0f temps réel)\n",
+            num_instances, threads, simulated_s / 3600.0, elapsed, simulated_s * 1000.0 / elapsed);
+    
+    free(ids);
+    free(fleet.results);
+    return mismatches > 0 ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,307 @@
+// Rejeu déterministe accéléré de traces capteurs enregistrées
+//
+// La trace (pression, température, mV des cellules O2, boutons) est injectée
+// par le HAL virtuel de Tools/host dans la boucle principale du firmware
+// (DiveComputer_RunOnce) ; la SysTick virtuelle avance du pas de la boucle.
+// Chaque valeur est tenue jusqu'à la ligne suivante, comme une lecture capteur.
+// La chronologie plafond/NDL/TTS/alarmes est écrite après chaque tâche 1 Hz.
+//
+// Compilation (depuis la racine du dépôt) :
+//   gcc -O2 -std=c11 -DHOST_SIMULATION -IApp/Inc -ITools/host Tools/dc_replay.c Tools/host/host_hal.c App/Src/dive_computer.c App/Src/dive_manager.c App/Src/dive_log.c App/Src/dive_codec.c App/Src/dive_store.c App/Src/ccr_manager.c App/Src/zhl16_core.c App/Src/zhl16_kernel.c App/Src/zhl16_fixed.c App/Src/zhl16_tox.c -lm -o dc_replay
+//
+// Usage : ./dc_replay [options] trace.csv > timeline.csv
+//   -u ms         pas de la boucle principale (défaut 20, comme la cible)
+//   -m oc|ccr|scr mode au démarrage (défaut oc)
+//   -s consigne   consigne CCR (bar)
+//   -g bas/haut   gradient factors
+//   -c            ZHL-16C
+//   -q            résumé seul (mesure de débit)
+//   -k            contrôle plafond/plan : si aucun plan publié de la plongée n'a
+//                 eu de palier, aucun événement CEILING relu en flash (code de
+//                 retour 1 sinon)
+//   -z heures     après la trace, veille profonde d'un bloc par le chemin de
+//                 main() (DiveComputer_CanDeepSleep, HAL_EnterDeepSleepMode,
+//                 DiveComputer_Wake) : désaturation et interdiction de vol
+//                 doivent avoir baissé du temps RTC écoulé (code de retour 1 sinon)
+//
+// Trace : lignes "secondes,pression_mbar,température[,mV1,mV2,mV3[,bouton]]"
+// (# ou en-tête non numérique ignorés). Bouton : valeur de ButtonEvent, rendue
+// une fois à l'instant de la ligne.
+//
+// Chronologie : t,profondeur,plafond,ndl,tts,gf99,cns,ppo2,phase,mode,alarmes
+// (alarmes séparées par '|') ; résumé, facteur temps réel et activité de la
+// flash simulée (journal des échantillons) sur stderr.
+#define _POSIX_C_SOURCE 200809L
+
+#include "host_hal.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define REPLAY_SLEEP_WAIT_MAX_S     3600    // Attente max de la veille après la trace
+#define REPLAY_SLEEP_TOL_MIN        1.0f    // Écart admis au réveil (minutes)
+
+// Trace capteurs
+typedef struct {
+    float time;
+    float pressure_mbar;
+    float temperature_c;
+    float cell_mv[3];
+    uint8_t button;
+} ReplayRow;
+
+typedef struct {
+    ReplayRow* rows;
+    uint32_t count;
+    uint32_t capacity;
+    bool has_cells;
+} ReplayTrace;
+
+static bool Replay_Load(const char* path, ReplayTrace* trace) {
+    FILE* file = fopen(path, "r");
+    char line[256];
+    if (!file) return false;
+    
+    memset(trace, 0, sizeof(ReplayTrace));
+    while (fgets(line, sizeof(line), file)) {
+        ReplayRow row = { 0 };
+        unsigned button = 0;
+        if (line[0] == '#') continue;
+        int fields = sscanf(line, "%f,%f,%f,%f,%f,%f,%u", &row.time, &row.pressure_mbar,
+                            &row.temperature_c, &row.cell_mv[0], &row.cell_mv[1], &row.cell_mv[2],
+                            &button);
+        if (fields < 3) continue;
+        if (fields >= 6) trace->has_cells = true;
+        row.button = (uint8_t)button;
+        
+        if (trace->count == trace->capacity) {
+            trace->capacity = trace->capacity ? trace->capacity * 2 : 4096;
+            trace->rows = realloc(trace->rows, sizeof(ReplayRow) * trace->capacity);
+        }
+        trace->rows[trace->count++] = row;
+    }
+    fclose(file);
+    return trace->count >= 2;
+}
+
+// Alarmes actives, séparées par '|' (celles de la boucle seulement en CCR/SCR,
+// comme à l'écran)
+static void Replay_Alarms(const DiveComputer* dc, char* buffer, size_t size) {
+    const char* names[6];
+    int count = 0;
+    bool loop = dc->mode == MODE_CCR || dc->mode == MODE_SCR;
+    
+    if (dc->dive.ascent_rate_alarm) names[count++] = "ASCENT";
+    if (dc->dive.deco_ceiling_alarm) names[count++] = "CEILING";
+    if (loop && dc->ccr.alarm_ppO2_high) names[count++] = "PPO2_HIGH";
+    if (loop && dc->ccr.alarm_ppO2_low) names[count++] = "PPO2_LOW";
+    if (loop && (dc->ccr.alarm_cells_failed || dc->ccr.alarm_cells_divergent)) names[count++] = "CELLS";
+    if (dc->emergency_mode) names[count++] = "SENSOR";
+    
+    buffer[0] = '\0';
+    for (int i = 0; i < count; i++) {
+        if (i > 0) strncat(buffer, "|", size - strlen(buffer) - 1);
+        strncat(buffer, names[i], size - strlen(buffer) - 1);
+    }
+    if (dc->ui.alarm_message[0]) {
+        if (count > 0) strncat(buffer, "|", size - strlen(buffer) - 1);
+        strncat(buffer, dc->ui.alarm_message, size - strlen(buffer) - 1);
+    }
+}
+
+// Veille profonde d'un bloc après la trace, comme la boucle de main() : éveillé
+// jusqu'à ce qu'elle soit permise, puis RTC avancée de `hours` heures et réveil
+static int Replay_DeepSleep(DiveComputer* dc, HostDevice* dev, float hours, uint32_t step_ms) {
+    const ZHL16Model* model = &dc->zhl16;
+    uint32_t limit = dev->tick_ms + REPLAY_SLEEP_WAIT_MAX_S * 1000u;
+    
+    while (!DiveComputer_CanDeepSleep(dc)) {
+        if (dev->tick_ms >= limit) {
+            fprintf(stderr, "ÉCHEC : veille profonde jamais permise après la trace\n");
+            return 1;
+        }
+        dev->tick_ms += step_ms;
+        DiveComputer_RunOnce(dc);
+    }
+    
+    // Valeurs de la dernière avance en surface, avant la veille
+    uint32_t since = dc->surface_rtc;
+    float desat = model->desat_time;
+    float nofly = model->nofly_time;
+    
+    dev->deep_sleep_s = (uint32_t)(hours * 3600.0f);
+    HAL_EnterDeepSleepMode();
+    DiveComputer_Wake(dc);
+    dev->deep_sleep_s = HAL_DEEP_SLEEP_WAKEUP_S;
+    
+    float elapsed = (HAL_RTCGetUnixTime() - since) / 60.0f;
+    float expected_desat = fmaxf(desat - elapsed, 0.0f);
+    float expected_nofly = fmaxf(nofly - elapsed, 0.0f);
+    fprintf(stderr, "veille profonde : %.1f h à la RTC, désaturation %.0f -> %.0f min (attendu %.0f), "
+            "interdiction de vol %.0f -> %.0f min (attendu %.0f)\n", elapsed / 60.0f, desat,
+            model->desat_time, expected_desat, nofly, model->nofly_time, expected_nofly);
+    if (dc->surface_rtc == since || fabsf(model->desat_time - expected_desat) > REPLAY_SLEEP_TOL_MIN ||
+        fabsf(model->nofly_time - expected_nofly) > REPLAY_SLEEP_TOL_MIN) {
+        fprintf(stderr, "ÉCHEC : intervalle de surface non rattrapé au réveil\n");
+        return 1;
+    }
+    return 0;
+}
+
+static double Replay_NowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+int main(int argc, char** argv) {
+    static const char* mode_names[] = { "SURFACE", "DIVE", "GAUGE", "APNEA", "CCR", "SCR", "BAILOUT" };
+    uint32_t step_ms = 20;
+    DiveMode mode = MODE_SURFACE;
+    float setpoint = 0;
+    float gf_low = 0, gf_high = 0;
+    bool zhl16c = false;
+    bool quiet = false;
+    bool check = false;
+    float sleep_hours = 0;
+    int opt;
+    
+    while ((opt = getopt(argc, argv, "u:m:s:g:cqkz:")) != -1) {
+        switch (opt) {
+            case 'u': step_ms = (uint32_t)atoi(optarg); break;
+            case 'm':
+                if (strcmp(optarg, "ccr") == 0) mode = MODE_CCR;
+                else if (strcmp(optarg, "scr") == 0) mode = MODE_SCR;
+                break;
+            case 's': setpoint = strtof(optarg, NULL); break;
+            case 'g': sscanf(optarg, "%f/%f", &gf_low, &gf_high); break;
+            case 'c': zhl16c = true; break;
+            case 'q': quiet = true; break;
+            case 'k': check = true; break;
+            case 'z': sleep_hours = strtof(optarg, NULL); break;
+            default: optind = argc; break;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "Usage : %s [-u ms] [-m oc|ccr|scr] [-s consigne] [-g bas/haut] [-c] [-q] [-k] [-z heures] trace.csv\n",
+                argv[0]);
+        return 2;
+    }
+    
+    ReplayTrace trace;
+    if (!Replay_Load(argv[optind], &trace)) {
+        fprintf(stderr, "Trace illisible : %s\n", argv[optind]);
+        return 2;
+    }
+    if (step_ms < 1 || step_ms > 1000) step_ms = 20;
+    
+    // Démarrage en surface sur la première ligne (pression de surface lue à l'init)
+    DiveComputer* dc = malloc(sizeof(DiveComputer));
+    HostDevice dev;
+    uint8_t* flash = malloc(HOST_FLASH_SIZE);
+    HostHAL_Init(&dev, trace.rows[0].pressure_mbar);
+    HostHAL_AttachFlash(&dev, flash);
+    dev.temperature_c = trace.rows[0].temperature_c;
+    HostHAL_Bind(&dev);
+    DiveComputer_Init(dc);
+    
+    if (zhl16c) ZHL16_SetModel(&dc->zhl16, true);
+    if (gf_high > 0) ZHL16_SetGradientFactors(&dc->zhl16, gf_low, gf_high);
+    if (setpoint > 0) dc->ccr.current_setpoint = setpoint;
+    if (mode != MODE_SURFACE) DiveComputer_SwitchMode(dc, mode);
+    
+    if (!quiet) printf("t,depth,ceiling,ndl,tts,gf99,cns,ppo2,phase,mode,alarms\n");
+    
+    uint32_t boot = dev.tick_ms;
+    uint32_t end = boot + (uint32_t)(trace.rows[trace.count - 1].time * 1000.0f);
+    uint32_t second = dc->last_second;
+    uint32_t row = 0;
+    uint32_t seconds = 0;
+    uint32_t alarm_seconds = 0;
+    uint32_t stop_seconds = 0;      // Plan publié avec palier(s)
+    float max_ceiling = 0;
+    uint16_t max_tts = 0;
+    char alarms[128];
+    
+    double start = Replay_NowMs();
+    for (uint32_t now = boot; now <= end; now += step_ms) {
+        float t = (now - boot) / 1000.0f;
+        
+        // Lignes échues : la dernière fixe les capteurs, chaque bouton est rendu une fois
+        while (row + 1 < trace.count && trace.rows[row + 1].time <= t) {
+            row++;
+            if (trace.rows[row].button) dev.button = (ButtonEvent)trace.rows[row].button;
+        }
+        const ReplayRow* r = &trace.rows[row];
+        dev.tick_ms = now;
+        dev.pressure_mbar = r->pressure_mbar;
+        dev.temperature_c = r->temperature_c;
+        memcpy(dev.cell_mv, r->cell_mv, sizeof(dev.cell_mv));
+        
+        DiveComputer_RunOnce(dc);
+        if (dc->last_second == second) continue;
+        second = dc->last_second;
+        
+        const ZHL16Model* model = &dc->zhl16;
+        uint16_t tts = model->ceiling > 0 ? model->ascend_plan.tts : 0;
+        Replay_Alarms(dc, alarms, sizeof(alarms));
+        seconds++;
+        if (alarms[0]) alarm_seconds++;
+        if (model->ceiling > max_ceiling) max_ceiling = model->ceiling;
+        if (tts > max_tts) max_tts = tts;
+        if (model->ceiling > 0 && model->ascend_plan.num_stops > 0) stop_seconds++;
+        
+        if (!quiet) {
+            float ppO2 = model->ccr_mode ? model->actual_ppO2
+                                         : model->ambient_pressure * model->gases[model->current_gas].fO2;
+            printf("%.0f,%.1f,%.0f,%.0f,%u,%.0f,%.1f,%.2f,%d,%s,%s\n", t, model->current_depth,
+                   model->ceiling, model->ceiling > 0 ? 0.0f : model->ndl, tts, model->gf_current,
+                   model->cns, ppO2, dc->dive.phase, mode_names[dc->mode], alarms);
+        }
+    }
+    double elapsed = Replay_NowMs() - start;
+    
+    double replayed_s = (end - boot) / 1000.0;
+    fprintf(stderr, "rejeu : %u lignes, %.1f min rejouées en %.1f ms (x%.0f temps réel), pas %u ms\n",
+            trace.count, replayed_s / 60.0, elapsed, replayed_s * 1000.0 / elapsed, step_ms);
+    fprintf(stderr, "plafond max %.0f m, TTS max %u min, CNS %.1f%%, %u s d'alarme sur %u s, %u plongée(s)\n",
+            max_ceiling, max_tts, dc->zhl16.cns, alarm_seconds, seconds,
+            dc->dive.store.last_dive);
+    fprintf(stderr, "flash : %u pages écrites, %u secteurs effacés, dernière plongée %u échantillons "
+            "(%u octets)\n", dev.flash_pages_written, dev.flash_sectors_erased,
+            dc->dive.current_dive.num_samples, dc->dive.current_dive.samples_bytes);
+    
+    int status = 0;
+    if (sleep_hours > 0) {
+        status = Replay_DeepSleep(dc, &dev, sleep_hours, step_ms);
+    }
+    
+    // Événements CEILING de la dernière plongée, relus en flash
+    if (check) {
+        static DiveSample samples[256];
+        const DiveProfile* profile = &dc->dive.current_dive;
+        uint32_t events = 0;
+        uint32_t first = 0;
+        uint16_t read;
+        while ((read = DiveManager_ReadSamples(profile, first, samples, 256)) > 0) {
+            for (uint16_t i = 0; i < read; i++) {
+                if (samples[i].events & DIVE_EVENT_CEILING) events++;
+            }
+            first += read;
+        }
+        fprintf(stderr, "contrôle : %u s de plan avec palier, %u événement(s) CEILING sur %u "
+                "échantillons\n", stop_seconds, events, first);
+        if (stop_seconds == 0 && events > 0) {
+            fprintf(stderr, "ÉCHEC : alarme de plafond sans palier au plan\n");
+            status = 1;
+        }
+    }
+    
+    free(flash);
+    free(trace.rows);
+    free(dc);
+    return status;
+}
\ No newline at end of file
@@ -0,0 +1,247 @@
+// Contrôle aller-retour de l'encodage des échantillons (dive_codec.c)
+//
+// Compilation (depuis la racine du dépôt) :
+//   gcc -O2 -std=c99 -IApp/Inc Tools/dive_codec_check.c App/Src/dive_codec.c -o dive_codec_check
+//
+// Usage : ./dive_codec_check
+// Profils synthétiques (loisir, déco multi-gaz, multi-niveaux, bruit capteur
+// compris) puis tirages aléatoires extrêmes : chaque flux est découpé en pages
+// comme par DiveLog, décodé bloc par bloc et comparé échantillon par échantillon.
+// Un bloc au marqueur détruit ne doit faire perdre que ses propres échantillons,
+// et aucun bloc ne doit être lu pour une autre plongée (tampon circulaire).
+// Sortie : taux de compression et coût d'encodage/décodage par échantillon ;
+// code retour 1 au premier écart.
+#define _POSIX_C_SOURCE 200809L
+
+#include "dive_codec.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK_MAX_SAMPLES   20000
+#define CHECK_TIMING_RUNS   20
+#define CHECK_DIVE_NUMBER   70001       // Au-delà de 16 bits : seuls les bits bas sont écrits
+
+// Flux découpé en pages (état effacé entre les blocs)
+typedef struct {
+    uint8_t* bytes;
+    uint32_t size;
+    uint32_t capacity;
+} CheckStream;
+
+static DiveSample check_samples[CHECK_MAX_SAMPLES];
+static DiveSample check_decoded[CHECK_MAX_SAMPLES];
+static uint32_t check_seed = 12345;
+
+static uint32_t Check_Random(void) {
+    check_seed = check_seed * 1103515245u + 12345u;
+    return check_seed >> 8;
+}
+
+static double Check_NowNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Profil par points (secondes, mètres), interpolé à 1 Hz avec bruit de
+// ±1 cm, thermocline et changements de gaz aux profondeurs de relais
+static uint32_t Check_Profile(const float (*points)[2], int num_points, const float* switch_depths,
+                              int num_switches) {
+    uint32_t n = 0;
+    uint8_t gas = 0;
+    float cns = 0;
+    
+    for (int p = 0; p + 1 < num_points && n < CHECK_MAX_SAMPLES; p++) {
+        float t0 = points[p][0], t1 = points[p + 1][0];
+        for (float t = t0; t < t1 && n < CHECK_MAX_SAMPLES; t += 1.0f) {
+            float depth = points[p][1] + (points[p + 1][1] - points[p][1]) * (t - t0) / (t1 - t0);
+            bool ascending = points[p + 1][1] < points[p][1];
+            DiveSample* s = &check_samples[n];
+            
+            while (ascending && gas < num_switches && depth <= switch_depths[gas]) gas++;
+            cns += depth / 4000.0f;
+            
+            s->time = (uint16_t)n;
+            s->depth = (int16_t)(depth * 100.0f) + (int16_t)(Check_Random() % 3) - 1;
+            s->temperature = (int16_t)(depth > 20.0f ? 120 : 200 - depth * 4.0f) + (Check_Random() % 16 == 0);
+            s->gas_idx = gas;
+            s->deco_time = points[p][1] > 6.0f ? (uint8_t)(depth / 3.0f) : 0;
+            s->cns = (uint8_t)cns;
+            s->events = (n > 0 && gas != check_samples[n - 1].gas_idx) ? 0x0001 : 0;
+            n++;
+        }
+    }
+    return n;
+}
+
+// Tirage extrême : sauts de temps, deltas pleine échelle, tous les champs
+static uint32_t Check_RandomProfile(uint32_t n) {
+    DiveSample s = { 0 };
+    
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t r = Check_Random();
+        s.time += (r % 8 == 0) ? (uint16_t)(Check_Random() % 70000) : 1;
+        s.depth = (r % 16 == 0) ? (int16_t)Check_Random() : (int16_t)(s.depth + (int16_t)(r % 41) - 20);
+        if (r % 5 == 0) s.temperature = (int16_t)Check_Random();
+        if (r % 7 == 0) s.gas_idx = (uint8_t)Check_Random();
+        if (r % 11 == 0) s.deco_time = (uint8_t)Check_Random();
+        if (r % 13 == 0) s.cns = (uint8_t)Check_Random();
+        if (r % 3 == 0) s.events = (uint16_t)Check_Random();
+        check_samples[i] = s;
+    }
+    return n;
+}
+
+static void Check_Append(CheckStream* stream, const uint8_t* data, uint32_t size) {
+    if (stream->size + size > stream->capacity) {
+        stream->capacity = (stream->size + size) * 2;
+        stream->bytes = realloc(stream->bytes, stream->capacity);
+    }
+    memcpy(&stream->bytes[stream->size], data, size);
+    stream->size += size;
+}
+
+static void Check_PadPage(CheckStream* stream) {
+    uint8_t erased[DIVE_CODEC_BLOCK_SIZE];
+    uint32_t rest = stream->size % DIVE_CODEC_BLOCK_SIZE;
+    if (rest == 0) return;
+    
+    memset(erased, 0xFF, sizeof(erased));
+    Check_Append(stream, erased, DIVE_CODEC_BLOCK_SIZE - rest);
+}
+
+static void Check_Encode(uint32_t n, CheckStream* stream) {
+    DiveCodec codec;
+    uint8_t record[DIVE_CODEC_MAX_RECORD];
+    bool new_block;
+    
+    stream->size = 0;
+    DiveCodec_Init(&codec, CHECK_DIVE_NUMBER);
+    for (uint32_t i = 0; i < n; i++) {
+        uint16_t size = DiveCodec_Encode(&codec, &check_samples[i], record, &new_block);
+        if (new_block) Check_PadPage(stream);
+        Check_Append(stream, record, size);
+    }
+    Check_PadPage(stream);
+}
+
+// Décodage de tous les blocs lisibles de la plongée dive_number, rangés à leur
+// index ; renvoie le nombre d'échantillons restitués
+static uint32_t Check_Decode(const CheckStream* stream, uint32_t dive_number, bool* present) {
+    uint32_t total = 0;
+    
+    for (uint32_t offset = 0; offset < stream->size; offset += DIVE_CODEC_BLOCK_SIZE) {
+        const uint8_t* block = &stream->bytes[offset];
+        uint32_t index;
+        uint16_t block_samples;
+        
+        if (!DiveCodec_BlockIndex(block, dive_number, &index) || index >= CHECK_MAX_SAMPLES) continue;
+        uint16_t count = DiveCodec_DecodeBlock(block, dive_number, 0, &check_decoded[index],
+                                               CHECK_MAX_SAMPLES - index, &block_samples);
+        for (uint16_t i = 0; i < count; i++) present[index + i] = true;
+        total += count;
+    }
+    return total;
+}
+
+static bool Check_Same(const DiveSample* a, const DiveSample* b) {
+    return a->time == b->time && a->depth == b->depth && a->temperature == b->temperature &&
+           a->gas_idx == b->gas_idx && a->deco_time == b->deco_time && a->cns == b->cns &&
+           a->events == b->events;
+}
+
+// Aller-retour complet, puis marqueur du bloc du milieu détruit
+static bool Check_RoundTrip(const char* name, uint32_t n) {
+    static bool present[CHECK_MAX_SAMPLES];
+    CheckStream stream = { 0 };
+    bool ok = true;
+    
+    Check_Encode(n, &stream);
+    memset(present, 0, sizeof(present));
+    uint32_t decoded = Check_Decode(&stream, CHECK_DIVE_NUMBER, present);
+    for (uint32_t i = 0; i < n && ok; i++) {
+        if (!present[i] || !Check_Same(&check_samples[i], &check_decoded[i])) {
+            printf("%s : écart à l'échantillon %u\n", name, i);
+            ok = false;
+        }
+    }
+    if (decoded != n) ok = false;
+    
+    // Mêmes blocs relus pour une autre plongée : tous rejetés
+    memset(present, 0, sizeof(present));
+    if (Check_Decode(&stream, CHECK_DIVE_NUMBER - 1, present) != 0) {
+        printf("%s : blocs acceptés pour une autre plongée\n", name);
+        ok = false;
+    }
+    
+    uint32_t blocks = stream.size / DIVE_CODEC_BLOCK_SIZE;
+    uint32_t lost_block = blocks / 2;
+    uint32_t lost_first = 0, lost_end = n;
+    DiveCodec_BlockIndex(&stream.bytes[lost_block * DIVE_CODEC_BLOCK_SIZE], CHECK_DIVE_NUMBER, &lost_first);
+    if (lost_block + 1 < blocks) {
+        DiveCodec_BlockIndex(&stream.bytes[(lost_block + 1) * DIVE_CODEC_BLOCK_SIZE], CHECK_DIVE_NUMBER,
+                             &lost_end);
+    }
+    stream.bytes[lost_block * DIVE_CODEC_BLOCK_SIZE] = 0x00;
+    memset(present, 0, sizeof(present));
+    Check_Decode(&stream, CHECK_DIVE_NUMBER, present);
+    for (uint32_t i = 0; i < n && ok; i++) {
+        bool lost = i >= lost_first && i < lost_end;
+        if (present[i] == lost || (!lost && !Check_Same(&check_samples[i], &check_decoded[i]))) {
+            printf("%s : resynchronisation incorrecte à l'échantillon %u\n", name, i);
+            ok = false;
+        }
+    }
+    
+    double start = Check_NowNs();
+    for (int run = 0; run < CHECK_TIMING_RUNS; run++) Check_Encode(n, &stream);
+    double encode_ns = (Check_NowNs() - start) / CHECK_TIMING_RUNS / n;
+    
+    start = Check_NowNs();
+    for (int run = 0; run < CHECK_TIMING_RUNS; run++) Check_Decode(&stream, CHECK_DIVE_NUMBER, present);
+    double decode_ns = (Check_NowNs() - start) / CHECK_TIMING_RUNS / n;
+    
+    uint32_t raw = n * (uint32_t)sizeof(DiveSample);
+    printf("%s,%u,%u,%u,%u,%.2f,%.1f,%.1f,%s\n", name, n, raw, stream.size, blocks,
+           (double)raw / stream.size, encode_ns, decode_ns, ok ? "OK" : "ECHEC");
+    free(stream.bytes);
+    return ok;
+}
+
+int main(void) {
+    static const float rec18[][2] = { { 0, 0 }, { 90, 18 }, { 2400, 18 }, { 2580, 5 }, { 2760, 5 }, { 2800, 0 } };
+    static const float deco40[][2] = { { 0, 0 }, { 120, 40 }, { 1500, 40 }, { 1710, 21 }, { 1830, 21 },
+                                       { 1850, 15 }, { 2000, 15 }, { 2020, 9 }, { 2300, 9 }, { 2320, 6 },
+                                       { 3000, 6 }, { 3020, 3 }, { 3900, 3 }, { 3960, 0 } };
+    static const float multi[][2] = { { 0, 0 }, { 100, 30 }, { 700, 30 }, { 800, 20 }, { 1600, 20 },
+                                      { 1700, 12 }, { 3000, 12 }, { 3100, 5 }, { 3280, 5 }, { 3320, 0 } };
+    static const float deco_switches[] = { 21, 6 };
+    bool ok = true;
+    
+    printf("profile,samples,raw_bytes,encoded_bytes,blocks,ratio,encode_ns,decode_ns,status\n");
+    ok &= Check_RoundTrip("rec18", Check_Profile(rec18, 6, NULL, 0));
+    ok &= Check_RoundTrip("deco40", Check_Profile(deco40, 14, deco_switches, 2));
+    ok &= Check_RoundTrip("multilevel", Check_Profile(multi, 10, NULL, 0));
+    for (int draw = 0; draw < 20; draw++) {
+        char name[32];
+        snprintf(name, sizeof(name), "random%d", draw);
+        ok &= Check_RoundTrip(name, Check_RandomProfile(CHECK_MAX_SAMPLES));
+    }
+    
+    // Blocs aléatoires au marqueur et au numéro de plongée valides : décodage borné au bloc
+    uint8_t block[DIVE_CODEC_BLOCK_SIZE];
+    for (int draw = 0; draw < 100000; draw++) {
+        uint16_t block_samples;
+        for (int i = 0; i < DIVE_CODEC_BLOCK_SIZE; i++) block[i] = (uint8_t)Check_Random();
+        block[0] = DIVE_CODEC_BLOCK_MARKER;
+        block[1] = (uint8_t)CHECK_DIVE_NUMBER;
+        block[2] = (uint8_t)(CHECK_DIVE_NUMBER >> 8);
+        DiveCodec_DecodeBlock(block, CHECK_DIVE_NUMBER, 0, check_decoded, CHECK_MAX_SAMPLES, &block_samples);
+        if (block_samples > DIVE_CODEC_BLOCK_SIZE) ok = false;
+    }
+    
+    printf("%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,242 @@
+// Contrôle du journal des plongées (dive_store.c) sur flash simulée
+//
+// Compilation (depuis la racine du dépôt) :
+//   gcc -O2 -std=c11 -DHOST_SIMULATION -IApp/Inc -ITools/host Tools/dive_store_check.c Tools/host/host_hal.c App/Src/dive_store.c -o dive_store_check
+//
+// Usage : ./dive_store_check
+// Coupures d'alimentation : pour chaque rang d'opération flash (écriture ou
+// effacement) d'une série d'ajouts, sur journal vide, sur anneau plein puis
+// sur table des résumés bouclée, l'opération visée n'est faite qu'à moitié. Après redémarrage et montage,
+// chaque plongée confirmée doit être relue à l'identique, la numérotation
+// reprendre après la dernière, et le journal accepter de nouveaux ajouts.
+// Puis usure (écarts d'effacements entre secteurs sur plusieurs tours
+// d'anneau) et coût du montage (lectures flash, durée SPI estimée). Table des
+// résumés : après chaque coupure, résumés des plongées confirmées conformes
+// (la dernière réparée si son entrée est encore effacée, sinon refaite depuis
+// son profil à la lecture) ; puis parcours du carnet par pages, une
+// lecture flash par page, bouclage de la table compris.
+// Code retour 1 au premier écart.
+#include "host_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK_DIVES_PER_RUN     100
+#define CHECK_SPI_HZ            20000000.0  // Horloge SPI de la W25Q64
+#define CHECK_SPI_COMMAND       4           // Octets commande + adresse par lecture
+#define CHECK_PAGE_ROWS         8           // Lignes du carnet par écran
+
+static uint8_t check_flash[HOST_FLASH_SIZE];
+
+// Profil de synthèse propre à chaque numéro
+static void Check_Profile(uint32_t dive_number, DiveProfile* profile) {
+    memset(profile, 0, sizeof(DiveProfile));
+    profile->dive_number = dive_number;
+    profile->start_timestamp = dive_number * 7200u;
+    profile->end_timestamp = profile->start_timestamp + 3000u + dive_number % 600u;
+    profile->start_rtc = 1700000000u + profile->start_timestamp;
+    profile->end_rtc = 1700000000u + profile->end_timestamp;
+    profile->duration = profile->end_timestamp - profile->start_timestamp;
+    profile->max_depth = 10.0f + (float)(dive_number % 50);
+    profile->avg_depth = profile->max_depth * 0.6f;
+    profile->max_cns = (float)(dive_number % 80);
+    profile->samples_address = DIVE_LOG_SAMPLES_BASE + (dive_number % 1000) * DIVE_LOG_SECTOR_SIZE;
+    profile->samples_bytes = 500u + dive_number % 4000u;
+    profile->num_samples = dive_number % 3000u;
+}
+
+static void Check_Summary(const DiveProfile* profile, DiveSummary* summary) {
+    memset(summary, 0, sizeof(DiveSummary));
+    summary->dive_number = profile->dive_number;
+    summary->start_rtc = profile->start_rtc;
+    summary->end_rtc = profile->end_rtc;
+    summary->duration = profile->duration;
+    summary->max_depth = (int16_t)(profile->max_depth * 100);
+    summary->avg_depth = (int16_t)(profile->avg_depth * 100);
+    summary->max_cns = (uint16_t)profile->max_cns;
+    summary->deco_violations = (uint8_t)(profile->dive_number % 3);
+}
+
+// Carnet parcouru par pages depuis la plus récente (entrée illisible refaite
+// depuis le profil, comme DiveManager_GetLogbookPage) : plongées [first, last]
+// toutes présentes, dans l'ordre, résumés conformes
+static bool Check_Logbook(const DiveStore* store, uint32_t first, uint32_t last) {
+    DiveSummary page[CHECK_PAGE_ROWS];
+    DiveSummary expected;
+    DiveProfile profile;
+    uint32_t next = last;
+    uint32_t total = DiveStore_SummaryCount(store);
+    
+    for (uint32_t rank = 0; rank < total && next >= first; rank += CHECK_PAGE_ROWS) {
+        uint16_t count = DiveStore_ReadSummaries(store, rank, page, CHECK_PAGE_ROWS);
+        for (uint16_t i = 0; i < count && next >= first; i++) {
+            if (page[i].dive_number == 0) {
+                if (!DiveStore_FindRank(store, rank + i, &profile, sizeof(DiveProfile))) continue;
+                Check_Summary(&profile, &page[i]);
+            }
+            Check_Profile(next, &profile);
+            Check_Summary(&profile, &expected);
+            if (page[i].dive_number != next || page[i].start_rtc != expected.start_rtc ||
+                page[i].duration != expected.duration || page[i].max_depth != expected.max_depth ||
+                page[i].deco_violations != expected.deco_violations) {
+                printf("carnet : rang %u, plongée %u lue, %u attendue\n", rank + i, page[i].dive_number, next);
+                return false;
+            }
+            next--;
+        }
+    }
+    if (next >= first) {
+        printf("carnet : plongée %u absente\n", next);
+        return false;
+    }
+    return true;
+}
+
+// Plongées [first, last] relues à l'identique
+static bool Check_Range(const DiveStore* store, uint32_t first, uint32_t last) {
+    DiveProfile expected, read;
+    
+    for (uint32_t n = first; n <= last; n++) {
+        Check_Profile(n, &expected);
+        if (!DiveStore_Find(store, n, &read, sizeof(DiveProfile)) ||
+            memcmp(&expected, &read, sizeof(DiveProfile)) != 0) {
+            printf("plongée %u illisible ou différente\n", n);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Ajouts jusqu'à `count` ou jusqu'à la coupure ; renvoie la dernière plongée confirmée
+static uint32_t Check_AppendRun(DiveStore* store, uint32_t count) {
+    DiveProfile profile;
+    DiveSummary summary;
+    uint32_t confirmed = store->last_dive;
+    
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t n = store->last_dive + 1;
+        Check_Profile(n, &profile);
+        Check_Summary(&profile, &summary);
+        if (!DiveStore_Append(store, n, &profile, sizeof(DiveProfile), &summary)) break;
+        confirmed = n;
+    }
+    return confirmed;
+}
+
+// Plus ancienne plongée encore garantie après `last` ajouts (anneau moins un secteur)
+static uint32_t Check_Oldest(uint32_t last) {
+    uint32_t kept = DIVE_STORE_CAPACITY - (DIVE_STORE_SLOTS - 1);
+    return last > kept ? last - kept + 1 : 1;
+}
+
+// Coupure à chaque rang d'opération d'une série d'ajouts, à partir de `prefill` plongées
+static bool Check_PowerCuts(HostDevice* dev, uint32_t prefill) {
+    DiveStore store;
+    uint32_t cuts = 0;
+    uint32_t torn = 0;
+    
+    for (uint32_t cut = 1;; cut++) {
+        HostHAL_Init(dev, 1013.0f);
+        HostHAL_AttachFlash(dev, check_flash);
+        DiveStore_Mount(&store);
+        uint32_t base = Check_AppendRun(&store, prefill);
+        
+        dev->flash_cut_after = dev->flash_ops + cut;
+        uint32_t confirmed = Check_AppendRun(&store, CHECK_DIVES_PER_RUN);
+        if (!dev->power_lost) break;
+        cuts++;
+        
+        HostHAL_PowerCycle(dev);
+        DiveStore_Mount(&store);
+        if (store.last_dive != confirmed) {
+            printf("coupure %u (base %u) : dernière plongée %u, attendu %u\n", cut, base, store.last_dive,
+                   confirmed);
+            return false;
+        }
+        if (!Check_Range(&store, Check_Oldest(confirmed), confirmed)) return false;
+        
+        // Résumé de la dernière plongée réparé comme au démarrage (DiveManager_Init)
+        DiveProfile profile;
+        DiveSummary summary;
+        if (confirmed > 0) {
+            Check_Profile(confirmed, &profile);
+            Check_Summary(&profile, &summary);
+            if (!DiveStore_RepairSummary(&store, &summary)) torn++;
+            if (!Check_Logbook(&store, Check_Oldest(confirmed), confirmed)) {
+                printf("coupure %u (base %u) : carnet incorrect\n", cut, base);
+                return false;
+            }
+        }
+        
+        // Reprise : nouveaux ajouts, relus après un second montage
+        uint32_t resumed = Check_AppendRun(&store, 2 * (DIVE_STORE_SLOTS - 1));
+        DiveStore_Mount(&store);
+        if (store.last_dive != resumed || !Check_Range(&store, Check_Oldest(resumed), resumed) ||
+            !Check_Logbook(&store, Check_Oldest(resumed), resumed)) {
+            printf("coupure %u (base %u) : reprise incorrecte\n", cut, base);
+            return false;
+        }
+    }
+    
+    printf("power_cuts prefill=%u cuts=%u torn_summaries=%u OK\n", prefill, cuts, torn);
+    return true;
+}
+
+int main(void) {
+    HostDevice dev;
+    DiveStore store;
+    bool ok = true;
+    
+    HostHAL_Bind(&dev);
+    ok &= Check_PowerCuts(&dev, 0);
+    ok &= Check_PowerCuts(&dev, DIVE_STORE_CAPACITY + DIVE_STORE_SLOTS / 2);
+    ok &= Check_PowerCuts(&dev, DIVE_STORE_SUMMARY_ENTRIES + DIVE_STORE_SUMMARIES_PER_SECTOR -
+                                CHECK_DIVES_PER_RUN / 2);
+    
+    // Usure : plusieurs tours d'anneau
+    HostHAL_Init(&dev, 1013.0f);
+    HostHAL_AttachFlash(&dev, check_flash);
+    DiveStore_Mount(&store);
+    uint32_t last = Check_AppendRun(&store, 5 * DIVE_STORE_CAPACITY + 10);
+    
+    // Montage du journal plein
+    dev.flash_reads = 0;
+    dev.flash_bytes_read = 0;
+    DiveStore_Mount(&store);
+    double mount_us = (dev.flash_bytes_read + dev.flash_reads * CHECK_SPI_COMMAND) * 8.0 / CHECK_SPI_HZ * 1e6;
+    printf("mount reads=%u bytes=%u spi_us=%.0f\n", dev.flash_reads, dev.flash_bytes_read, mount_us);
+    
+    uint16_t min_erase = 0xFFFF, max_erase = 0;
+    for (int s = 0; s < DIVE_STORE_SECTORS; s++) {
+        if (store.sectors[s].erase_count < min_erase) min_erase = store.sectors[s].erase_count;
+        if (store.sectors[s].erase_count > max_erase) max_erase = store.sectors[s].erase_count;
+    }
+    printf("wear dives=%u capacity=%u erase_min=%u erase_max=%u\n", last, DIVE_STORE_CAPACITY, min_erase,
+           max_erase);
+    ok &= store.last_dive == last && max_erase - min_erase <= 1;
+    ok &= Check_Range(&store, Check_Oldest(last), last);
+    
+    // Recherche : lectures par plongée ; liste, plus récentes d'abord
+    dev.flash_reads = 0;
+    ok &= Check_Range(&store, last - 99, last);
+    printf("find reads_per_dive=%.1f\n", dev.flash_reads / 100.0);
+    
+    uint32_t list[40];
+    uint16_t count = DiveStore_List(&store, list, 40);
+    for (uint16_t i = 0; i < count; i++) {
+        if (list[i] != last - i) ok = false;
+    }
+    ok &= count == 40;
+    
+    // Carnet : pages de résumés, une lecture par page (table bouclée)
+    dev.flash_reads = 0;
+    dev.flash_bytes_read = 0;
+    ok &= Check_Logbook(&store, last - DIVE_STORE_SUMMARY_RETAINED + 1, last);
+    uint32_t pages = (DIVE_STORE_SUMMARY_RETAINED + CHECK_PAGE_ROWS - 1) / CHECK_PAGE_ROWS;
+    printf("logbook dives=%u pages=%u reads=%u bytes_per_page=%u\n", DiveStore_SummaryCount(&store), pages,
+           dev.flash_reads, dev.flash_bytes_read / pages);
+    ok &= dev.flash_reads <= pages + 1;
+    
+    printf("%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,207 @@
+// HAL virtuel hôte (voir host_hal.h)
+#include "host_hal.h"
+#include "ui_screens.h"
+#include <string.h>
+
+uint32_t SystemCoreClock = HOST_CORE_CLOCK_HZ;
+
+// Périphérique du thread courant
+static _Thread_local HostDevice* host_device;
+
+void HostHAL_Init(HostDevice* dev, float surface_mbar) {
+    memset(dev, 0, sizeof(HostDevice));
+    dev->tick_ms = HOST_BOOT_TICK_MS;
+    dev->rtc_epoch = HOST_RTC_EPOCH;
+    dev->deep_sleep_s = HAL_DEEP_SLEEP_WAKEUP_S;
+    dev->pressure_mbar = surface_mbar;
+    dev->temperature_c = 20.0f;
+    dev->battery_voltage = 4.0f;
+    dev->battery_percent = 80;
+}
+
+void HostHAL_AttachFlash(HostDevice* dev, uint8_t* image) {
+    memset(image, 0xFF, HOST_FLASH_SIZE);
+    dev->flash = image;
+}
+
+void HostHAL_PowerCycle(HostDevice* dev) {
+    dev->power_lost = false;
+    dev->flash_cut_after = 0;
+    dev->flash_busy_polls = 0;
+}
+
+void HostHAL_Bind(HostDevice* dev) {
+    host_device = dev;
+}
+
+float HostHAL_DepthToMbar(const DiveComputer* dc, float depth) {
+    return dc->zhl16.surface_pressure * 1000.0f + depth * 100.0f;
+}
+
+// HAL_* utilisés par les modules firmware
+// ----------------------------------------------------------------------------
+
+void HAL_InitHardware(void) {
+}
+
+bool HAL_ReadPressureTemp(float* pressure_mbar, float* temperature_c) {
+    *pressure_mbar = host_device->pressure_mbar;
+    *temperature_c = host_device->temperature_c;
+    return !host_device->sensor_fail;
+}
+
+void HAL_ReadO2Cells(float* cell1_mv, float* cell2_mv, float* cell3_mv) {
+    *cell1_mv = host_device->cell_mv[0];
+    *cell2_mv = host_device->cell_mv[1];
+    *cell3_mv = host_device->cell_mv[2];
+}
+
+ButtonEvent HAL_GetButtonEvent(void) {
+    ButtonEvent event = host_device->button;
+    host_device->button = BUTTON_NONE;
+    return event;
+}
+
+float HAL_GetBatteryVoltage(void) {
+    return host_device->battery_voltage;
+}
+
+uint8_t HAL_GetBatteryPercent(void) {
+    return host_device->battery_percent;
+}
+
+void HAL_WatchdogFeed(void) {
+}
+
+uint32_t HAL_GetSysTick(void) {
+    return host_device->tick_ms;
+}
+
+uint32_t HAL_RTCGetUnixTime(void) {
+    return host_device->rtc_epoch + host_device->tick_ms / 1000;
+}
+
+// Mode STOP : SysTick arrêtée, la RTC avance de deep_sleep_s (un réveil
+// périodique par défaut, plusieurs heures pour simuler une longue veille)
+void HAL_EnterDeepSleepMode(void) {
+    host_device->rtc_epoch += host_device->deep_sleep_s;
+    host_device->deep_sleeps++;
+}
+
+// Compteur avancé à chaque lecture : les tranches du planificateur font
+// le même nombre de pas d'une exécution à l'autre
+uint32_t HAL_GetCycleCount(void) {
+    host_device->cycles += HOST_CYCLES_PER_READ;
+    return host_device->cycles;
+}
+
+// Coupure programmée atteinte par cette écriture ou cet effacement
+static bool HostHAL_FlashCut(void) {
+    host_device->flash_ops++;
+    if (host_device->flash_cut_after && host_device->flash_ops == host_device->flash_cut_after) {
+        host_device->power_lost = true;
+        return true;
+    }
+    return false;
+}
+
+// Flash NOR : un bit ne repasse à 1 que par effacement du secteur. Coupure
+// pendant l'écriture : seule la première moitié des octets est programmée.
+bool HAL_FlashWrite(uint32_t address, uint8_t* data, uint32_t size) {
+    uint8_t* flash = host_device->flash;
+    if (!flash) return true;
+    if (host_device->power_lost || host_device->flash_busy_polls) return false;
+    if (address > HOST_FLASH_SIZE || size > HOST_FLASH_SIZE - address) return false;
+    
+    bool cut = HostHAL_FlashCut();
+    uint32_t programmed = cut ? size / 2 : size;
+    for (uint32_t i = 0; i < programmed; i++) {
+        flash[address + i] &= data[i];
+    }
+    host_device->flash_pages_written += (size + DIVE_LOG_PAGE_SIZE - 1) / DIVE_LOG_PAGE_SIZE;
+    return !cut;
+}
+
+bool HAL_FlashRead(uint32_t address, uint8_t* data, uint32_t size) {
+    uint8_t* flash = host_device->flash;
+    if (!flash || host_device->power_lost || host_device->flash_busy_polls) return false;
+    if (address > HOST_FLASH_SIZE || size > HOST_FLASH_SIZE - address) return false;
+    
+    memcpy(data, &flash[address], size);
+    host_device->flash_reads++;
+    host_device->flash_bytes_read += size;
+    return true;
+}
+
+// Coupure pendant l'effacement : seule la seconde moitié du secteur est
+// effacée (l'en-tête d'origine reste lisible)
+bool HAL_FlashEraseSector(uint32_t sector) {
+    uint8_t* flash = host_device->flash;
+    if (!flash) return true;
+    if (host_device->power_lost || host_device->flash_busy_polls) return false;
+    if (sector >= DIVE_LOG_FLASH_SECTORS) return false;
+    
+    bool cut = HostHAL_FlashCut();
+    uint32_t start = cut ? DIVE_LOG_SECTOR_SIZE / 2 : 0;
+    memset(&flash[sector * DIVE_LOG_SECTOR_SIZE + start], 0xFF, DIVE_LOG_SECTOR_SIZE - start);
+    host_device->flash_sectors_erased++;
+    return !cut;
+}
+
+// Effacement lancé : fait tout de suite, mais la flash reste occupée pendant
+// HOST_FLASH_ERASE_POLLS lectures de HAL_FlashIsBusy
+bool HAL_FlashEraseSectorStart(uint32_t sector) {
+    if (!HAL_FlashEraseSector(sector)) return false;
+    
+    if (host_device->flash) {
+        host_device->flash_busy_polls = HOST_FLASH_ERASE_POLLS;
+    }
+    return true;
+}
+
+bool HAL_FlashIsBusy(void) {
+    if (host_device->flash_busy_polls == 0 || host_device->power_lost) return false;
+    
+    host_device->flash_busy_polls--;
+    return true;
+}
+
+// Interface sans écran : seul l'état de dc->ui est tenu
+// ----------------------------------------------------------------------------
+
+void UI_Init(DiveComputer* dc) {
+    memset(&dc->ui, 0, sizeof(UIState));
+    dc->ui.current_screen = SCREEN_MAIN_DIVE;
+}
+
+void UI_Update(DiveComputer* dc) {
+    (void)dc;
+}
+
+void UI_SwitchScreen(DiveComputer* dc, ScreenType screen) {
+    dc->ui.current_screen = screen;
+}
+
+void UI_ForceRedraw(DiveComputer* dc) {
+    (void)dc;
+}
+
+void UI_ShowAlarm(DiveComputer* dc, const char* message, uint8_t severity) {
+    (void)severity;
+    strncpy(dc->ui.alarm_message, message, sizeof(dc->ui.alarm_message) - 1);
+    dc->ui.last_alarm_time = host_device->tick_ms;
+}
+
+void UI_ClearAlarm(DiveComputer* dc) {
+    dc->ui.alarm_message[0] = '\0';
+}
+
+// Fonctions déclarées sans implémentation dans le firmware
+// ----------------------------------------------------------------------------
+
+// Statistiques de boucle : non simulées
+void CCR_Update(CCRManager* ccr, float ambient_pressure, float temperature) {
+    (void)ccr;
+    (void)ambient_pressure;
+    (void)temperature;
+}
\ No newline at end of file
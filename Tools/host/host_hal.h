@@ -0,0 +1,74 @@
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+// HAL virtuel pour exécuter les modules firmware sur l'hôte (simulateurs)
+//
+// Chaque DiveComputer simulé a son HostDevice : horloge SysTick, RTC,
+// compteur de cycles et capteurs. Le thread qui fait avancer une instance
+// y lie son périphérique (HostHAL_Bind) : les appels HAL_* du firmware
+// lisent alors le périphérique du thread courant.
+//
+// Compilation : -DHOST_SIMULATION -ITools/host, sans hardware_hal.c ni
+// ui_screens.c (affichage sans écran fourni ici)
+
+#include "dive_computer.h"
+
+#define HOST_CORE_CLOCK_HZ      168000000u
+#define HOST_CYCLES_PER_READ    2000u       // Avance du compteur à chaque lecture
+#define HOST_BOOT_TICK_MS       1000u       // SysTick au démarrage (0 : « pas de mesure »)
+#define HOST_RTC_EPOCH          1700000000u
+#define HOST_FLASH_SIZE         (DIVE_LOG_FLASH_SECTORS * DIVE_LOG_SECTOR_SIZE)
+#define HOST_FLASH_ERASE_POLLS  4u          // Lectures de BUSY pendant un effacement lancé
+
+// Périphérique virtuel
+typedef struct {
+    // Horloges
+    uint32_t tick_ms;               // HAL_GetSysTick
+    uint32_t rtc_epoch;             // HAL_RTCGetUnixTime à tick 0
+    uint32_t cycles;                // HAL_GetCycleCount (déterministe)
+    uint32_t deep_sleep_s;          // Durée d'une veille profonde (RTC seule avancée)
+    uint32_t deep_sleeps;           // Appels de HAL_EnterDeepSleepMode
+    
+    // Capteurs, écrits par le simulateur avant chaque mise à jour
+    float pressure_mbar;
+    float temperature_c;
+    float cell_mv[3];
+    bool sensor_fail;               // HAL_ReadPressureTemp en échec
+    float battery_voltage;
+    uint8_t battery_percent;
+    ButtonEvent button;             // Rendu une fois par HAL_GetButtonEvent
+    
+    // Flash SPI : image de HOST_FLASH_SIZE octets avec la sémantique NOR
+    // (écriture = ET bit à bit, effacement à 0xFF) ; NULL : flash absente,
+    // écritures ignorées et lectures en échec
+    uint8_t* flash;
+    uint32_t flash_pages_written;
+    uint32_t flash_sectors_erased;
+    uint32_t flash_reads;
+    uint32_t flash_bytes_read;
+    uint32_t flash_busy_polls;      // Lectures de BUSY restantes (toute autre opération échoue)
+    
+    // Coupure d'alimentation : la flash_cut_after-ième écriture ou effacement
+    // n'est fait qu'à moitié, puis toute opération flash échoue jusqu'au
+    // redémarrage (0 : pas de coupure)
+    uint32_t flash_ops;
+    uint32_t flash_cut_after;
+    bool power_lost;
+} HostDevice;
+
+// Périphérique en surface à tick HOST_BOOT_TICK_MS
+void HostHAL_Init(HostDevice* dev, float surface_mbar);
+
+// Branche une image flash (HOST_FLASH_SIZE octets, remise à l'état effacé)
+void HostHAL_AttachFlash(HostDevice* dev, uint8_t* image);
+
+// Redémarrage après coupure : image flash conservée, coupure désarmée
+void HostHAL_PowerCycle(HostDevice* dev);
+
+// Lie le périphérique au thread appelant (NULL : délie)
+void HostHAL_Bind(HostDevice* dev);
+
+// Profondeur en mètres vers pression capteur (inverse de DiveComputer_Update)
+float HostHAL_DepthToMbar(const DiveComputer* dc, float depth);
+
+#endif
\ No newline at end of file
@@ -0,0 +1,17 @@
+#ifndef STM32F4XX_HAL_H
+#define STM32F4XX_HAL_H
+
+// Remplaçant hôte du HAL STM32 : juste ce que les en-têtes de l'application
+// utilisent, pour compiler les modules firmware avec Tools/host/host_hal.c
+
+#include <stdint.h>
+
+#define GPIO_PIN_4      0x0010u
+#define TIM_CHANNEL_1   0x0000u
+
+extern uint32_t SystemCoreClock;
+
+static inline void HAL_Init(void) {}
+static inline void __WFI(void) {}
+
+#endif
\ No newline at end of file
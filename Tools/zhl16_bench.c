@@ -0,0 +1,304 @@
+// Banc de mesure hôte du moteur de décompression ZHL-16
+//
+// Compilation (depuis la racine du dépôt) :
+//   gcc -O2 -std=c99 -IApp/Inc Tools/zhl16_bench.c App/Src/zhl16_core.c App/Src/zhl16_kernel.c App/Src/zhl16_fixed.c App/Src/zhl16_tox.c -lm -o zhl16_bench
+//
+// Usage : ./zhl16_bench [répétitions]
+// Sortie CSV sur stdout (une ligne par profil et par fonction) :
+//   profile,function,calls,calls_per_tick,ns_per_call,worst_ns
+//
+// Usage : ./zhl16_bench decay [répétitions]
+// Cache des facteurs de décroissance : ZHL16_UpdateTissues avec le cache, puis
+// sans (cache vidé avant chaque appel : 32 exponentielles recalculées, coût du
+// vidage compris), meilleure série de BENCH_DECAY_CALLS appels par pas de temps :
+//   step_s,ns_cached,ns_uncached,ns_saved_per_call
+// Les durées sont corrigées du coût de la mesure. Les noyaux du chemin compilé
+// sont d'abord contrôlés contre la référence scalaire (code retour 1 en échec). Comparer deux versions :
+//   ./zhl16_bench > avant.csv ; ... ; ./zhl16_bench > apres.csv
+#define _POSIX_C_SOURCE 199309L
+
+#include "zhl16_core.h"
+#include "zhl16_kernel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_DEFAULT_REPEAT 5
+#define BENCH_MAX_SEGMENTS   8
+#define BENCH_DECAY_CALLS    100     // Appels par série mesurée
+#define BENCH_DECAY_SERIES   40      // Séries par répétition (meilleure retenue)
+
+// Fonctions mesurées
+typedef enum {
+    BENCH_UPDATE_TISSUES,
+    BENCH_GET_CEILING,
+    BENCH_GET_NDL,
+    BENCH_ASCEND_PLAN,
+    BENCH_NUM_FUNCTIONS
+} BenchFunction;
+
+static const char* bench_function_names[BENCH_NUM_FUNCTIONS] = {
+    "ZHL16_UpdateTissues",
+    "ZHL16_GetCeiling",
+    "ZHL16_GetNDL",
+    "ZHL16_CalculateAscendPlan"
+};
+
+// Statistiques d'une fonction
+typedef struct {
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t worst_ns;
+} BenchStats;
+
+// Segment de profil : profondeur cible et durée au fond (consigne CCR optionnelle)
+typedef struct {
+    float depth;
+    uint16_t minutes;
+    float setpoint;         // 0 : inchangée
+} BenchSegment;
+
+// Profil de plongée du corpus
+typedef struct {
+    const char* name;
+    struct {
+        const char* name;
+        float fO2;
+        float fHe;
+    } gases[4];
+    uint8_t num_gases;
+    bool ccr;
+    float deco_setpoint;    // Consigne CCR pendant la remontée
+    BenchSegment segments[BENCH_MAX_SEGMENTS];
+    uint8_t num_segments;
+} BenchProfile;
+
+static const BenchProfile bench_profiles[] = {
+    {
+        "rec_air",
+        { { "Air", 0.21, 0.0 } }, 1,
+        false, 0,
+        { { 18.0, 45, 0 } }, 1
+    },
+    {
+        "nitrox_deco",
+        { { "EAN28", 0.28, 0.0 }, { "EAN50", 0.50, 0.0 }, { "Oxygen", 1.00, 0.0 } }, 3,
+        false, 0,
+        { { 40.0, 35, 0 } }, 1
+    },
+    {
+        "trimix_100",
+        { { "TX10/70", 0.10, 0.70 }, { "TX21/35", 0.21, 0.35 },
+          { "EAN50", 0.50, 0.0 }, { "Oxygen", 1.00, 0.0 } }, 4,
+        false, 0,
+        { { 100.0, 20, 0 } }, 1
+    },
+    {
+        "ccr_setpoints",
+        { { "TX15/50", 0.15, 0.50 } }, 1,
+        true, 1.6,
+        { { 20.0, 2, 0.7 }, { 60.0, 40, 1.3 }, { 45.0, 15, 1.2 } }, 3
+    }
+};
+
+#define BENCH_NUM_PROFILES (sizeof(bench_profiles) / sizeof(bench_profiles[0]))
+
+static uint64_t bench_overhead_ns;
+
+static uint64_t Bench_Now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Coût minimal d'une paire de lectures d'horloge (retranché des mesures)
+static void Bench_CalibrateOverhead(void) {
+    uint64_t best = UINT64_MAX;
+    for (int i = 0; i < 10000; i++) {
+        uint64_t start = Bench_Now();
+        uint64_t elapsed = Bench_Now() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    bench_overhead_ns = best;
+}
+
+static void Bench_Record(BenchStats* stats, uint64_t start) {
+    uint64_t elapsed = Bench_Now() - start;
+    elapsed = elapsed > bench_overhead_ns ? elapsed - bench_overhead_ns : 0;
+    stats->calls++;
+    stats->total_ns += elapsed;
+    if (elapsed > stats->worst_ns) {
+        stats->worst_ns = elapsed;
+    }
+}
+
+// Une seconde de plongée, comme DiveComputer_1HzTasks
+static void Bench_Tick(ZHL16Model* model, ZHL16PlannerJob* job, float depth, BenchStats* stats) {
+    uint64_t start;
+    
+    ZHL16_UpdateDepth(model, depth);
+    if (model->ccr_mode) {
+        // ppO2 mesurée : consigne, bornée par la pression ambiante
+        float ppO2 = model->setpoint < model->ambient_pressure ? model->setpoint : model->ambient_pressure;
+        ZHL16_UpdateCCRppO2(model, ppO2);
+    }
+    
+    start = Bench_Now();
+    ZHL16_UpdateTissues(model, 1.0);
+    Bench_Record(&stats[BENCH_UPDATE_TISSUES], start);
+    
+    start = Bench_Now();
+    ZHL16_GetCeiling(model);
+    Bench_Record(&stats[BENCH_GET_CEILING], start);
+    
+    if (model->ceiling > 0) {
+        start = Bench_Now();
+        ZHL16_CalculateAscendPlan(job, model);
+        Bench_Record(&stats[BENCH_ASCEND_PLAN], start);
+    } else {
+        start = Bench_Now();
+        ZHL16_GetNDL(model);
+        Bench_Record(&stats[BENCH_GET_NDL], start);
+    }
+}
+
+// Déroule un profil : segments puis remontée en suivant le plan publié
+static uint32_t Bench_RunProfile(const BenchProfile* profile, BenchStats* stats) {
+    ZHL16Model model;
+    ZHL16PlannerJob job;
+    uint32_t ticks = 0;
+    float depth = 0;
+    
+    ZHL16_Init(&model, 1.013, false);
+    for (uint8_t i = 0; i < profile->num_gases; i++) {
+        float fO2 = profile->gases[i].fO2;
+        float fHe = profile->gases[i].fHe;
+        ZHL16_AddGas(&model, i, profile->gases[i].name, fO2, 1.0 - fO2 - fHe, fHe, profile->ccr);
+    }
+    if (profile->ccr) {
+        ZHL16_SetCCRMode(&model, true, profile->segments[0].setpoint);
+    }
+    
+    // Segments : déplacement à la vitesse configurée puis temps au fond
+    for (uint8_t s = 0; s < profile->num_segments; s++) {
+        const BenchSegment* seg = &profile->segments[s];
+        if (seg->setpoint > 0) {
+            model.setpoint = seg->setpoint;
+        }
+        
+        while (depth != seg->depth) {
+            float rate = (seg->depth > depth ? model.config.descent_rate : model.config.ascent_rate) / 60.0;
+            depth += seg->depth > depth ? rate : -rate;
+            if (fabsf(depth - seg->depth) < rate) depth = seg->depth;
+            Bench_Tick(&model, &job, depth, stats);
+            ticks++;
+        }
+        for (uint32_t t = 0; t < seg->minutes * 60u; t++) {
+            Bench_Tick(&model, &job, depth, stats);
+            ticks++;
+        }
+    }
+    
+    // Remontée : jusqu'au premier palier du plan, puis attente de sa levée
+    if (profile->ccr) {
+        model.setpoint = profile->deco_setpoint;
+    }
+    while (depth > 0 && ticks < 24 * 3600) {
+        float target = 0;
+        if (model.ceiling > 0 && model.ascend_plan.is_valid && model.ascend_plan.num_stops > 0) {
+            target = model.ascend_plan.stops[0].depth;
+        }
+        if (depth > target) {
+            depth -= model.config.ascent_rate / 60.0;
+            if (depth < target) depth = target;
+        }
+        if (!profile->ccr) {
+            ZHL16_SwitchGas(&model, ZHL16_GetBestGas(&model, depth));
+        }
+        Bench_Tick(&model, &job, depth, stats);
+        ticks++;
+    }
+    
+    return ticks;
+}
+
+// Meilleure durée d'une série d'appels de ZHL16_UpdateTissues, cache vidé ou non
+static uint64_t Bench_DecaySeries(ZHL16Model* model, float step_s, bool uncached, int series) {
+    uint64_t best = UINT64_MAX;
+    
+    for (int s = 0; s < series; s++) {
+        uint64_t start = Bench_Now();
+        for (int i = 0; i < BENCH_DECAY_CALLS; i++) {
+            if (uncached) ZHL16_InvalidateDecayCache(model);
+            ZHL16_UpdateTissues(model, step_s);
+        }
+        uint64_t elapsed = Bench_Now() - start;
+        if (elapsed < best) best = elapsed;
+    }
+    return best > bench_overhead_ns ? best - bench_overhead_ns : 0;
+}
+
+// Gain du cache des facteurs par pas de temps récurrent : seconde en remontée,
+// intervalle en palier stable (TISSUE_STEADY_MAX_INTERVAL_S)
+static void Bench_DecayCache(int repeat) {
+    static const float steps[] = { 1.0f, 5.0f };
+    ZHL16Model model;
+    
+    ZHL16_Init(&model, 1.013, false);
+    ZHL16_AddGas(&model, 0, "Air", 0.21, 0.79, 0.0, false);
+    ZHL16_UpdateDepth(&model, 30.0);
+    
+    printf("step_s,ns_cached,ns_uncached,ns_saved_per_call\n");
+    for (size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+        int series = BENCH_DECAY_SERIES * repeat;
+        double cached = (double)Bench_DecaySeries(&model, steps[i], false, series) / BENCH_DECAY_CALLS;
+        double uncached = (double)Bench_DecaySeries(&model, steps[i], true, series) / BENCH_DECAY_CALLS;
+        printf("%.0f,%.1f,%.1f,%.1f\n", steps[i], cached, uncached, uncached - cached);
+    }
+}
+
+int main(int argc, char** argv) {
+    bool decay = argc > 1 && strcmp(argv[1], "decay") == 0;
+    if (decay) {
+        argc--;
+        argv++;
+    }
+    int repeat = argc > 1 ? atoi(argv[1]) : BENCH_DEFAULT_REPEAT;
+    if (repeat < 1) repeat = 1;
+    
+    if (!ZHL16K_SelfTest(&ZHL16B_Coefficients, ZHL16K_SELFTEST_TOLERANCE) ||
+        !ZHL16K_SelfTest(&ZHL16C_Coefficients, ZHL16K_SELFTEST_TOLERANCE)) {
+        fprintf(stderr, "Noyaux %s différents de la référence scalaire\n", ZHL16K_PATH_NAME);
+        return 1;
+    }
+    
+    Bench_CalibrateOverhead();
+    if (decay) {
+        Bench_DecayCache(repeat);
+        return 0;
+    }
+    
+    printf("profile,function,calls,calls_per_tick,ns_per_call,worst_ns\n");
+    
+    for (size_t p = 0; p < BENCH_NUM_PROFILES; p++) {
+        BenchStats stats[BENCH_NUM_FUNCTIONS] = { { 0 } };
+        uint64_t ticks = 0;
+        
+        for (int r = 0; r < repeat; r++) {
+            ticks += Bench_RunProfile(&bench_profiles[p], stats);
+        }
+        
+        for (int f = 0; f < BENCH_NUM_FUNCTIONS; f++) {
+            const BenchStats* st = &stats[f];
+            printf("%s,%s,%llu,%.3f,%.1f,%llu\n",
+                   bench_profiles[p].name, bench_function_names[f],
+                   (unsigned long long)st->calls,
+                   (double)st->calls / ticks,
+                   st->calls ? (double)st->total_ns / st->calls : 0.0,
+                   (unsigned long long)st->worst_ns);
+        }
+    }
+    
+    return 0;
+}
\ No newline at end of file
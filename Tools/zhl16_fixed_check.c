@@ -0,0 +1,211 @@
+// Contrôle du moteur virgule fixe contre le moteur float sur un corpus de profils
+//
+// Compilation (depuis la racine du dépôt), une fois par moteur :
+//   gcc -O2 -std=c99 -IApp/Inc Tools/zhl16_fixed_check.c App/Src/zhl16_core.c App/Src/zhl16_kernel.c App/Src/zhl16_fixed.c App/Src/zhl16_tox.c -lm -o check_float
+//   gcc -O2 -std=c99 -DZHL16_FIXED_POINT -IApp/Inc Tools/zhl16_fixed_check.c App/Src/zhl16_core.c App/Src/zhl16_kernel.c App/Src/zhl16_fixed.c App/Src/zhl16_tox.c -lm -o check_fixed
+//
+// Usage :
+//   ./check_float > reference.csv        (valeurs de référence)
+//   ./check_fixed reference.csv          (écarts, code retour 1 hors budget)
+// Chaque minute de fond : plafond, NDL, TTS et saturation ; en fin de fond :
+// les 32 pressions tissulaires. Au préalable, auto-test des noyaux du chemin
+// compilé contre la référence scalaire (ZHL-16B et C ; code retour 1 en échec).
+#include "zhl16_core.h"
+#include "zhl16_kernel.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Budget d'écart accepté (voir zhl16_fixed.h)
+#define CHECK_MAX_TISSUE_BAR    1e-3
+#define CHECK_MAX_NDL_MIN       1.0
+#define CHECK_MAX_TTS_MIN       1
+#define CHECK_MAX_CEILING_RATIO 0.01    // Part max de plafonds arrondis différents
+
+typedef enum {
+    MIX_AIR,
+    MIX_NITROX_DECO,
+    MIX_TRIMIX,
+    MIX_CCR,
+    MIX_COUNT
+} CheckMix;
+
+static const float check_depths[] = { 12, 18, 25, 30, 40, 50, 60, 70, 85, 100 };
+static const uint16_t check_minutes[] = { 10, 20, 30, 45, 60 };
+
+#define CHECK_NUM_DEPTHS  (sizeof(check_depths) / sizeof(check_depths[0]))
+#define CHECK_NUM_MINUTES (sizeof(check_minutes) / sizeof(check_minutes[0]))
+
+// Écarts observés
+typedef struct {
+    FILE* reference;        // NULL : mode référence (écriture sur stdout)
+    double max_tissue;
+    double max_ndl;
+    int max_tts;
+    uint32_t samples;
+    uint32_t ceiling_mismatch;
+    uint32_t tts_mismatch;
+    bool format_error;
+} CheckState;
+
+static void Check_SetupGases(ZHL16Model* model, CheckMix mix) {
+    switch (mix) {
+        case MIX_AIR:
+            ZHL16_AddGas(model, 0, "Air", 0.21, 0.79, 0.0, false);
+            break;
+        case MIX_NITROX_DECO:
+            ZHL16_AddGas(model, 0, "EAN28", 0.28, 0.72, 0.0, false);
+            ZHL16_AddGas(model, 1, "EAN50", 0.50, 0.50, 0.0, false);
+            ZHL16_AddGas(model, 2, "Oxygen", 1.00, 0.00, 0.0, false);
+            break;
+        case MIX_TRIMIX:
+            ZHL16_AddGas(model, 0, "TX15/55", 0.15, 0.30, 0.55, false);
+            ZHL16_AddGas(model, 1, "TX21/35", 0.21, 0.44, 0.35, false);
+            ZHL16_AddGas(model, 2, "EAN50", 0.50, 0.50, 0.0, false);
+            ZHL16_AddGas(model, 3, "Oxygen", 1.00, 0.00, 0.0, false);
+            break;
+        case MIX_CCR:
+            ZHL16_AddGas(model, 0, "TX18/45", 0.18, 0.37, 0.45, true);
+            ZHL16_SetCCRMode(model, true, 1.3);
+            break;
+        default:
+            break;
+    }
+}
+
+// Échantillon : écrit en mode référence, comparé à la ligne lue sinon
+static void Check_Sample(CheckState* st, int profile, int minute, ZHL16Model* model) {
+    float ceiling = model->ceiling;
+    float ndl = model->ceiling > 0 ? 0 : ZHL16_GetNDL(model);
+    int tts = model->ceiling > 0 ? model->ascend_plan.tts : 0;
+    
+    if (!st->reference) {
+        printf("S,%d,%d,%.1f,%.4f,%d,%.4f\n", profile, minute, ceiling, ndl, tts,
+               model->saturation_percent);
+        return;
+    }
+    
+    int ref_profile, ref_minute, ref_tts;
+    float ref_ceiling, ref_ndl, ref_saturation;
+    if (fscanf(st->reference, " S,%d,%d,%f,%f,%d,%f", &ref_profile, &ref_minute, &ref_ceiling,
+               &ref_ndl, &ref_tts, &ref_saturation) != 6 ||
+        ref_profile != profile || ref_minute != minute) {
+        st->format_error = true;
+        return;
+    }
+    
+    st->samples++;
+    if (ref_ceiling != ceiling) st->ceiling_mismatch++;
+    if (ref_tts != tts) st->tts_mismatch++;
+    if (abs(ref_tts - tts) > st->max_tts) st->max_tts = abs(ref_tts - tts);
+    if (fabs(ref_ndl - ndl) > st->max_ndl) st->max_ndl = fabs(ref_ndl - ndl);
+}
+
+static void Check_Tissues(CheckState* st, int profile, const ZHL16Model* model) {
+    const TissueState* t = &model->tissues;
+    
+    if (!st->reference) {
+        printf("T,%d", profile);
+        for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+            printf(",%.7f,%.7f", ZHL16_PRESSURE_F(t->pressure_N2[i]), ZHL16_PRESSURE_F(t->pressure_He[i]));
+        }
+        printf("\n");
+        return;
+    }
+    
+    int ref_profile;
+    if (fscanf(st->reference, " T,%d", &ref_profile) != 1 || ref_profile != profile) {
+        st->format_error = true;
+        return;
+    }
+    for (int i = 0; i < NUM_COMPARTMENTS; i++) {
+        float ref_N2, ref_He;
+        if (fscanf(st->reference, ",%f,%f", &ref_N2, &ref_He) != 2) {
+            st->format_error = true;
+            return;
+        }
+        double d_N2 = fabs(ref_N2 - ZHL16_PRESSURE_F(t->pressure_N2[i]));
+        double d_He = fabs(ref_He - ZHL16_PRESSURE_F(t->pressure_He[i]));
+        if (d_N2 > st->max_tissue) st->max_tissue = d_N2;
+        if (d_He > st->max_tissue) st->max_tissue = d_He;
+    }
+}
+
+// Descente à 20 m/min puis fond, une mise à jour par seconde
+static void Check_RunProfile(CheckState* st, int profile, CheckMix mix, float depth, uint16_t minutes) {
+    ZHL16Model model;
+    ZHL16PlannerJob job;
+    float current = 0;
+    
+    ZHL16_Init(&model, 1.013, false);
+    Check_SetupGases(&model, mix);
+    
+    for (uint32_t s = 1; s <= minutes * 60u && !st->format_error; s++) {
+        if (current < depth) {
+            current += model.config.descent_rate / 60.0;
+            if (current > depth) current = depth;
+        }
+        ZHL16_UpdateDepth(&model, current);
+        if (model.ccr_mode) {
+            ZHL16_UpdateCCRppO2(&model, model.setpoint < model.ambient_pressure ? model.setpoint : model.ambient_pressure);
+        }
+        ZHL16_UpdateTissues(&model, 1.0);
+        
+        if (s % 60 == 0) {
+            ZHL16_GetCeiling(&model);
+            if (model.ceiling > 0) {
+                ZHL16_CalculateAscendPlan(&job, &model);
+            }
+            Check_Sample(st, profile, s / 60, &model);
+        }
+    }
+    
+    Check_Tissues(st, profile, &model);
+}
+
+int main(int argc, char** argv) {
+    CheckState st = { 0 };
+    int profile = 0;
+    
+    if (!ZHL16K_SelfTest(&ZHL16B_Coefficients, ZHL16K_SELFTEST_TOLERANCE) ||
+        !ZHL16K_SelfTest(&ZHL16C_Coefficients, ZHL16K_SELFTEST_TOLERANCE)) {
+        fprintf(stderr, "Noyaux %s différents de la référence scalaire\n", ZHL16K_PATH_NAME);
+        return 1;
+    }
+    
+    if (argc > 1) {
+        st.reference = fopen(argv[1], "r");
+        if (!st.reference) {
+            fprintf(stderr, "Référence introuvable : %s\n", argv[1]);
+            return 2;
+        }
+    }
+    
+    for (int mix = 0; mix < MIX_COUNT; mix++) {
+        for (size_t d = 0; d < CHECK_NUM_DEPTHS; d++) {
+            for (size_t m = 0; m < CHECK_NUM_MINUTES; m++) {
+                Check_RunProfile(&st, profile++, (CheckMix)mix, check_depths[d], check_minutes[m]);
+            }
+        }
+    }
+    
+    if (!st.reference) return 0;
+    fclose(st.reference);
+    
+    if (st.format_error) {
+        fprintf(stderr, "Référence incompatible avec ce corpus\n");
+        return 2;
+    }
+    
+    double ceiling_ratio = st.samples ? (double)st.ceiling_mismatch / st.samples : 0;
+    printf("profiles=%d samples=%u\n", profile, st.samples);
+    printf("tissue_max_diff_bar=%.3g\n", st.max_tissue);
+    printf("ceiling_mismatch=%u (%.2f%%)\n", st.ceiling_mismatch, ceiling_ratio * 100);
+    printf("ndl_max_diff_min=%.3f\n", st.max_ndl);
+    printf("tts_mismatch=%u tts_max_diff_min=%d\n", st.tts_mismatch, st.max_tts);
+    
+    bool ok = st.max_tissue <= CHECK_MAX_TISSUE_BAR && st.max_ndl <= CHECK_MAX_NDL_MIN &&
+              st.max_tts <= CHECK_MAX_TTS_MIN && ceiling_ratio <= CHECK_MAX_CEILING_RATIO;
+    printf("%s\n", ok ? "OK" : "HORS BUDGET");
+    
+    return ok ? 0 : 1;
+}
\ No newline at end of file
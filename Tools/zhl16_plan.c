@@ -0,0 +1,124 @@
+// Planificateur de plongée hôte : tables de runtime et grille de sensibilité
+//
+// Compilation (depuis la racine du dépôt) :
+//   gcc -O2 -std=c99 -pthread -IApp/Inc Tools/zhl16_plan.c Tools/zhl16_planner.c App/Src/zhl16_core.c App/Src/zhl16_kernel.c App/Src/zhl16_fixed.c App/Src/zhl16_tox.c -lm -o zhl16_plan
+//
+// Usage : ./zhl16_plan plan.csv [threads]     (threads : nombre de cœurs par défaut)
+//
+// Fichier de planification, une entrée par ligne (# : commentaire) :
+//   model,C                        ZHL-16C (B par défaut)
+//   surface,1.013                  Pression de surface (bar), avant les gaz
+//   gf,30,85                       Gradient factors bas/haut (%)
+//   ascent_rate,9                  Vitesses (m/min)
+//   descent_rate,20
+//   gas,TX18/45,0.18,0.45          nom, fO2, fHe [, ppO2 max] [, diluent] [, bailout]
+//   ccr,1.3                        Recycleur, consigne (le premier gaz est le diluant)
+//   level,60,20                    profondeur, minutes au niveau [, gaz] [, consigne]
+//   grid_depth,30:60:3             Axes de la grille : listes ou plages début:fin:pas
+//   grid_time,10:40:5              (durée au fond descente comprise)
+//   grid_gf,30/70,30/85,50/85      Paires de GF
+//
+// Sortie CSV sur stdout :
+//   stop,variante,profondeur,minutes,runtime,gaz   paliers (nominal, lost_gas, bailout)
+//   tts,variante,minutes,runtime                   fin de chaque variante
+//   grid,profondeur,minutes,gf_bas,gf_haut,tts,premier_palier,minutes_de_paliers
+#define _POSIX_C_SOURCE 200809L
+
+#include "zhl16_planner.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static double Plan_NowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+}
+
+// Table de runtime d'une variante : paliers puis arrivée en surface (même
+// cumul que les paliers ; le TTS publié en est l'arrondi à la minute)
+static void Plan_PrintPlan(const char* variant, const PlanInput* input, const PlanResult* result,
+                           const AscendPlan* plan) {
+    const ZHL16Model* model = &input->base;
+    float runtime = result->bottom_runtime;
+    float depth = result->bottom_depth;
+    
+    if (!plan->is_valid) return;
+    
+    for (uint8_t s = 0; s < plan->num_stops; s++) {
+        const DecoStop* stop = &plan->stops[s];
+        runtime += (depth - stop->depth) / model->config.ascent_rate + stop->time / 60.0f;
+        depth = stop->depth;
+        printf("stop,%s,%.0f,%u,%.1f,%s\n", variant, stop->depth, stop->time / 60, runtime,
+               model->gases[stop->gas_idx].name);
+    }
+    runtime += depth / model->config.ascent_rate;
+    printf("tts,%s,%u,%.1f\n", variant, plan->tts, runtime);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage : %s plan.csv [threads]\n", argv[0]);
+        return 2;
+    }
+    
+    FILE* file = fopen(argv[1], "r");
+    if (!file) {
+        fprintf(stderr, "Fichier introuvable : %s\n", argv[1]);
+        return 2;
+    }
+    
+    PlanInput* input = malloc(sizeof(PlanInput));
+    char error[128];
+    bool loaded = Plan_Load(file, input, error, sizeof(error));
+    fclose(file);
+    if (!loaded) {
+        fprintf(stderr, "%s : %s\n", argv[1], error);
+        free(input);
+        return 2;
+    }
+    
+    int threads = argc > 2 ? atoi(argv[2]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    
+    // Profil : plan nominal et variantes
+    if (input->num_levels > 0) {
+        PlanResult result;
+        Plan_RunProfile(input, &result);
+        
+        printf("stop,variant,depth,minutes,runtime,gas\n");
+        Plan_PrintPlan("nominal", input, &result, &result.plan);
+        if (result.lost_gas_idx != ZHL16_NO_GAS) {
+            Plan_PrintPlan("lost_gas", input, &result, &result.lost_gas);
+        }
+        if (result.has_bailout) {
+            Plan_PrintPlan("bailout", input, &result, &result.bailout);
+        }
+        printf("# CNS %.0f%%, OTU %.0f en fin de fond", result.cns, result.otu);
+        if (result.lost_gas_idx != ZHL16_NO_GAS) {
+            printf(", lost_gas : sans %s", input->base.gases[result.lost_gas_idx].name);
+        }
+        printf("\n");
+    }
+    
+    // Grille de sensibilité
+    uint32_t num_cells = Plan_GridSize(input);
+    if (num_cells > 0) {
+        PlanCell* cells = malloc(sizeof(PlanCell) * num_cells);
+        double start = Plan_NowMs();
+        Plan_RunGrid(input, cells, threads);
+        double elapsed = Plan_NowMs() - start;
+        
+        printf("grid,depth,minutes,gf_low,gf_high,tts,first_stop,deco_minutes\n");
+        for (uint32_t c = 0; c < num_cells; c++) {
+            const PlanCell* cell = &cells[c];
+            printf("grid,%.0f,%.0f,%.0f,%.0f,%u,%.0f,%u\n", cell->depth, cell->minutes,
+                   cell->gf_low, cell->gf_high, cell->tts, cell->first_stop, cell->deco_minutes);
+        }
+        fprintf(stderr, "grille : %u cellules, %d threads, %.1f ms\n", num_cells, threads, elapsed);
+        free(cells);
+    }
+    
+    free(input);
+    return 0;
+}
\ No newline at end of file
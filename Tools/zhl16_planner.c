@@ -0,0 +1,332 @@
+// Planificateur hôte multi-niveaux (voir zhl16_planner.h)
+//
+// Le moteur est réentrant tant que chaque thread a son propre modèle et ses
+// propres calculs de plan (zones de travail ZHL16PlannerJob/ZHL16ScenarioJob).
+#define _POSIX_C_SOURCE 200809L
+
+#include "zhl16_planner.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Lecture CSV
+// ----------------------------------------------------------------------------
+
+// Découpe une ligne en champs (commentaires # et espaces de bord retirés)
+static int Plan_SplitLine(char* line, char** fields) {
+    int count = 0;
+    char* comment = strchr(line, '#');
+    if (comment) *comment = '\0';
+    
+    char* field = strtok(line, ",\r\n");
+    while (field && count < PLAN_MAX_FIELDS) {
+        while (*field == ' ' || *field == '\t') field++;
+        char* end = field + strlen(field);
+        while (end > field && (end[-1] == ' ' || end[-1] == '\t')) *--end = '\0';
+        fields[count++] = field;
+        field = strtok(NULL, ",\r\n");
+    }
+    
+    return count == 1 && fields[0][0] == '\0' ? 0 : count;
+}
+
+// Valeurs d'un axe de grille : liste "a,b,c" ou plages "début:fin:pas"
+static bool Plan_ParseAxis(char** fields, int count, float* values, uint16_t* num) {
+    *num = 0;
+    for (int f = 1; f < count; f++) {
+        float start, stop, step;
+        if (sscanf(fields[f], "%f:%f:%f", &start, &stop, &step) == 3) {
+            if (step <= 0) return false;
+            for (float v = start; v <= stop + step * 1e-3f; v += step) {
+                if (*num >= PLAN_MAX_GRID) return false;
+                values[(*num)++] = v;
+            }
+        } else if (sscanf(fields[f], "%f", &start) == 1) {
+            if (*num >= PLAN_MAX_GRID) return false;
+            values[(*num)++] = start;
+        } else {
+            return false;
+        }
+    }
+    return *num > 0;
+}
+
+// Nombre complet (false si le champ contient autre chose)
+static bool Plan_ParseNumber(const char* field, float* value) {
+    char* end;
+    *value = strtof(field, &end);
+    return end != field && *end == '\0';
+}
+
+static uint8_t Plan_FindGas(const ZHL16Model* model, const char* name) {
+    for (uint8_t i = 0; i < model->num_gases; i++) {
+        if (strcmp(model->gases[i].name, name) == 0) return i;
+    }
+    return ZHL16_NO_GAS;
+}
+
+bool Plan_Load(FILE* file, PlanInput* input, char* error, size_t error_size) {
+    ZHL16Model* model = &input->base;
+    char line[512];
+    char* fields[PLAN_MAX_FIELDS];
+    float surface = 1.013f;
+    bool zhl16c = false;
+    int line_number = 0;
+    
+    memset(input, 0, sizeof(PlanInput));
+    ZHL16_Init(model, surface, zhl16c);
+    
+    while (fgets(line, sizeof(line), file)) {
+        line_number++;
+        int count = Plan_SplitLine(line, fields);
+        if (count == 0) continue;
+        
+        const char* key = fields[0];
+        bool ok = true;
+        
+        if (strcmp(key, "model") == 0 && count == 2) {
+            zhl16c = strcmp(fields[1], "C") == 0;
+            ZHL16_SetModel(model, zhl16c);
+        } else if (strcmp(key, "surface") == 0 && count == 2) {
+            // Réinitialise le modèle : à placer avant les gaz
+            surface = strtof(fields[1], NULL);
+            DecoConfig config = model->config;
+            ZHL16_Init(model, surface, zhl16c);
+            model->config = config;
+        } else if (strcmp(key, "gf") == 0 && count == 3) {
+            ZHL16_SetGradientFactors(model, strtof(fields[1], NULL), strtof(fields[2], NULL));
+        } else if (strcmp(key, "ascent_rate") == 0 && count == 2) {
+            model->config.ascent_rate = strtof(fields[1], NULL);
+        } else if (strcmp(key, "descent_rate") == 0 && count == 2) {
+            model->config.descent_rate = strtof(fields[1], NULL);
+        } else if (strcmp(key, "gas") == 0 && count >= 4) {
+            // gas,nom,fO2,fHe[,ppO2_max][,diluent][,bailout]
+            uint8_t idx = model->num_gases;
+            float fO2 = 0;
+            float fHe = 0;
+            bool diluent = false;
+            bool bailout = false;
+            float ppO2_max = 0;
+            for (int f = 4; f < count; f++) {
+                if (strcmp(fields[f], "diluent") == 0) diluent = true;
+                else if (strcmp(fields[f], "bailout") == 0) bailout = true;
+                else ok = ok && Plan_ParseNumber(fields[f], &ppO2_max);
+            }
+            ok = ok && idx < MAX_GASES && Plan_ParseNumber(fields[2], &fO2) &&
+                 Plan_ParseNumber(fields[3], &fHe) && fO2 > 0 && fHe >= 0 && fO2 + fHe <= 1.0f;
+            if (ok) {
+                ZHL16_AddGas(model, idx, fields[1], fO2, 1.0f - fO2 - fHe, fHe, diluent);
+                model->gases[idx].is_bailout = bailout;
+                if (ppO2_max > 0) {
+                    ZHL16_SetGasLimits(model, idx, model->gases[idx].ppO2_min, ppO2_max);
+                }
+            }
+        } else if (strcmp(key, "ccr") == 0 && count == 2) {
+            ZHL16_SetCCRMode(model, true, strtof(fields[1], NULL));
+        } else if (strcmp(key, "level") == 0 && count >= 3) {
+            // level,profondeur,minutes[,gaz][,consigne]
+            ok = input->num_levels < PLAN_MAX_LEVELS;
+            if (ok) {
+                PlanLevel* level = &input->levels[input->num_levels++];
+                level->gas = ZHL16_NO_GAS;
+                level->setpoint = 0;
+                ok = Plan_ParseNumber(fields[1], &level->depth) && level->depth >= 0 &&
+                     Plan_ParseNumber(fields[2], &level->minutes) && level->minutes >= 0;
+                for (int f = 3; f < count && ok; f++) {
+                    float value;
+                    if (Plan_ParseNumber(fields[f], &value)) {
+                        level->setpoint = value;
+                    } else {
+                        level->gas = Plan_FindGas(model, fields[f]);
+                        ok = level->gas != ZHL16_NO_GAS;
+                    }
+                }
+            }
+        } else if (strcmp(key, "grid_depth") == 0) {
+            ok = Plan_ParseAxis(fields, count, input->grid_depth, &input->num_grid_depth);
+        } else if (strcmp(key, "grid_time") == 0) {
+            ok = Plan_ParseAxis(fields, count, input->grid_minutes, &input->num_grid_minutes);
+        } else if (strcmp(key, "grid_gf") == 0) {
+            // Paires "bas/haut"
+            input->num_grid_gf = 0;
+            for (int f = 1; f < count && ok; f++) {
+                ok = input->num_grid_gf < PLAN_MAX_GRID &&
+                     sscanf(fields[f], "%f/%f", &input->grid_gf_low[input->num_grid_gf],
+                            &input->grid_gf_high[input->num_grid_gf]) == 2;
+                input->num_grid_gf++;
+            }
+        } else {
+            ok = false;
+        }
+        
+        if (!ok) {
+            snprintf(error, error_size, "ligne %d : entrée invalide (%s)", line_number, key);
+            return false;
+        }
+    }
+    
+    if (model->num_gases == 0) {
+        snprintf(error, error_size, "aucun gaz");
+        return false;
+    }
+    return true;
+}
+
+// Simulation et plans
+// ----------------------------------------------------------------------------
+
+// Déplacement linéaire puis séjour à la profondeur (toxicité O2 comprise)
+static void Plan_Move(ZHL16Model* model, float depth, float hold_seconds) {
+    float from = model->current_depth;
+    float rate = depth > from ? model->config.descent_rate : model->config.ascent_rate;
+    float travel_seconds = fabsf(depth - from) / rate * 60.0f;
+    float start_ambient = model->ambient_pressure;
+    
+    ZHL16_UpdateDepth(model, depth);
+    if (model->ccr_mode) {
+        ZHL16_UpdateCCRppO2(model, fminf(model->setpoint, model->ambient_pressure));
+    }
+    if (travel_seconds > 0) {
+        ZHL16_UpdateTissuesLinear(model, start_ambient, model->ambient_pressure, travel_seconds);
+        ZHL16_UpdateCNS(model, travel_seconds);
+        ZHL16_UpdateOTU(model, travel_seconds);
+    }
+    if (hold_seconds > 0) {
+        ZHL16_UpdateTissues(model, hold_seconds);
+        ZHL16_UpdateCNS(model, hold_seconds);
+        ZHL16_UpdateOTU(model, hold_seconds);
+    }
+}
+
+// Plan nominal et scénarios what-if (perte de gaz) sur l'état courant
+static void Plan_Ascend(ZHL16Model* model, ZHL16ScenarioJob* batch) {
+    ZHL16_ScenariosBegin(batch, model);
+    while (!ZHL16_ScenariosStep(batch, model)) {
+    }
+}
+
+void Plan_RunProfile(const PlanInput* input, PlanResult* result) {
+    ZHL16Model* model = malloc(sizeof(ZHL16Model));
+    ZHL16ScenarioJob* batch = malloc(sizeof(ZHL16ScenarioJob));
+    float runtime = 0;
+    
+    *model = input->base;
+    memset(result, 0, sizeof(PlanResult));
+    
+    for (uint8_t l = 0; l < input->num_levels; l++) {
+        const PlanLevel* level = &input->levels[l];
+        float rate = level->depth > model->current_depth ? model->config.descent_rate
+                                                         : model->config.ascent_rate;
+        
+        if (level->gas != ZHL16_NO_GAS) ZHL16_SwitchGas(model, level->gas);
+        if (level->setpoint > 0) model->setpoint = level->setpoint;
+        runtime += fabsf(level->depth - model->current_depth) / rate + level->minutes;
+        Plan_Move(model, level->depth, level->minutes * 60.0f);
+    }
+    
+    Plan_Ascend(model, batch);
+    result->plan = model->ascend_plan;
+    result->lost_gas = model->what_if[WHATIF_LOST_GAS];
+    result->lost_gas_idx = model->what_if_lost_gas;
+    
+    if (model->ccr_mode) {
+        ZHL16PlannerJob* job = &batch->job;
+        ZHL16_PlannerBeginBailout(job, model);
+        while (!ZHL16_PlannerStep(job, model)) {
+        }
+        ZHL16_PlannerPublish(job, model);
+        result->bailout = model->what_if[WHATIF_BAILOUT];
+        result->has_bailout = true;
+    }
+    
+    result->bottom_depth = model->current_depth;
+    result->bottom_runtime = runtime;
+    result->cns = model->cns;
+    result->otu = model->otu;
+    
+    free(batch);
+    free(model);
+}
+
+uint32_t Plan_GridSize(const PlanInput* input) {
+    return (uint32_t)input->num_grid_depth * input->num_grid_minutes * input->num_grid_gf;
+}
+
+// Une cellule : descente, fond jusqu'à la durée totale, plan au GF de la cellule
+static void Plan_RunCell(const PlanInput* input, ZHL16Model* model, ZHL16ScenarioJob* batch,
+                         PlanCell* cell) {
+    *model = input->base;
+    ZHL16_SetGradientFactors(model, cell->gf_low, cell->gf_high);
+    
+    float descent_minutes = cell->depth / model->config.descent_rate;
+    Plan_Move(model, cell->depth, fmaxf(cell->minutes - descent_minutes, 0.0f) * 60.0f);
+    Plan_Ascend(model, batch);
+    
+    const AscendPlan* plan = &model->ascend_plan;
+    uint32_t deco_seconds = 0;
+    for (uint8_t s = 0; s < plan->num_stops; s++) {
+        deco_seconds += plan->stops[s].time;
+    }
+    cell->tts = plan->tts;
+    cell->first_stop = plan->num_stops > 0 ? plan->first_stop_depth : 0;
+    cell->deco_minutes = deco_seconds / 60;
+}
+
+// Répartition des cellules : thread t traite t, t + n, t + 2n...
+typedef struct {
+    const PlanInput* input;
+    PlanCell* cells;
+    uint32_t num_cells;
+    int index;
+    int stride;
+} PlanWorker;
+
+static void* Plan_Worker(void* arg) {
+    PlanWorker* worker = arg;
+    ZHL16Model* model = malloc(sizeof(ZHL16Model));
+    ZHL16ScenarioJob* batch = malloc(sizeof(ZHL16ScenarioJob));
+    
+    for (uint32_t c = worker->index; c < worker->num_cells; c += worker->stride) {
+        Plan_RunCell(worker->input, model, batch, &worker->cells[c]);
+    }
+    
+    free(batch);
+    free(model);
+    return NULL;
+}
+
+void Plan_RunGrid(const PlanInput* input, PlanCell* cells, int threads) {
+    uint32_t num_cells = Plan_GridSize(input);
+    uint32_t c = 0;
+    
+    // Ordre de sortie : profondeur, durée, puis GF
+    for (uint16_t d = 0; d < input->num_grid_depth; d++) {
+        for (uint16_t t = 0; t < input->num_grid_minutes; t++) {
+            for (uint16_t g = 0; g < input->num_grid_gf; g++) {
+                PlanCell* cell = &cells[c++];
+                memset(cell, 0, sizeof(PlanCell));
+                cell->depth = input->grid_depth[d];
+                cell->minutes = input->grid_minutes[t];
+                cell->gf_low = input->grid_gf_low[g];
+                cell->gf_high = input->grid_gf_high[g];
+            }
+        }
+    }
+    
+    if (threads < 1) threads = 1;
+    if ((uint32_t)threads > num_cells) threads = num_cells > 0 ? num_cells : 1;
+    
+    pthread_t* ids = malloc(sizeof(pthread_t) * threads);
+    PlanWorker* workers = malloc(sizeof(PlanWorker) * threads);
+    for (int t = 0; t < threads; t++) {
+        workers[t] = (PlanWorker){ input, cells, num_cells, t, threads };
+        if (t > 0) pthread_create(&ids[t], NULL, Plan_Worker, &workers[t]);
+    }
+    Plan_Worker(&workers[0]);
+    for (int t = 1; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+    }
+    
+    free(workers);
+    free(ids);
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#ifndef ZHL16_PLANNER_H
+#define ZHL16_PLANNER_H
+
+#include "zhl16_core.h"
+#include <stdio.h>
+#include <stddef.h>
+
+// Planificateur hôte multi-niveaux sur le moteur ZHL-16 (zhl16_core.c) :
+// profil et liste de gaz lus en CSV, plan nominal et variantes (perte de gaz,
+// bailout), grille de sensibilité profondeur x durée x GF calculée en parallèle
+
+#define PLAN_MAX_LEVELS     32
+#define PLAN_MAX_GRID       128     // Valeurs max par axe de la grille
+#define PLAN_MAX_FIELDS     16      // Champs max par ligne CSV
+
+// Niveau du profil : déplacement aux vitesses configurées puis séjour
+typedef struct {
+    float depth;
+    float minutes;          // Séjour à la profondeur, déplacement non compris
+    uint8_t gas;            // ZHL16_NO_GAS : gaz du niveau précédent
+    float setpoint;         // CCR, 0 : inchangée
+} PlanLevel;
+
+// Entrée : modèle configuré (gaz, GF, vitesses, mode), profil et grille
+typedef struct {
+    ZHL16Model base;
+    PlanLevel levels[PLAN_MAX_LEVELS];
+    uint8_t num_levels;
+    
+    // Grille : plongée à un niveau (durée descente comprise) par paire de GF
+    float grid_depth[PLAN_MAX_GRID];
+    float grid_minutes[PLAN_MAX_GRID];
+    float grid_gf_low[PLAN_MAX_GRID];
+    float grid_gf_high[PLAN_MAX_GRID];
+    uint16_t num_grid_depth;
+    uint16_t num_grid_minutes;
+    uint16_t num_grid_gf;
+} PlanInput;
+
+// Plan nominal et variantes d'un profil
+typedef struct {
+    AscendPlan plan;
+    AscendPlan lost_gas;        // Sans le premier gaz de déco du plan nominal
+    AscendPlan bailout;         // CCR : circuit ouvert sur les gaz bailout
+    uint8_t lost_gas_idx;       // ZHL16_NO_GAS si aucun changement de gaz
+    bool has_bailout;
+    float bottom_depth;         // Profondeur en fin de profil
+    float bottom_runtime;       // Minutes en fin de profil
+    float cns;
+    float otu;
+} PlanResult;
+
+// Cellule de la grille de sensibilité
+typedef struct {
+    float depth;
+    float minutes;
+    float gf_low;
+    float gf_high;
+    float first_stop;           // 0 : sans palier
+    uint16_t tts;
+    uint16_t deco_minutes;      // Somme des paliers
+} PlanCell;
+
+// Lecture du fichier de planification (false et message d'erreur si invalide)
+bool Plan_Load(FILE* file, PlanInput* input, char* error, size_t error_size);
+
+// Profil complet : plongée simulée puis plans
+void Plan_RunProfile(const PlanInput* input, PlanResult* result);
+
+// Grille : cellules indépendantes réparties sur threads fils (cells : Plan_GridSize éléments)
+uint32_t Plan_GridSize(const PlanInput* input);
+void Plan_RunGrid(const PlanInput* input, PlanCell* cells, int threads);
+
+#endif
\ No newline at end of file
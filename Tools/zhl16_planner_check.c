@@ -0,0 +1,182 @@
+// Contrôle du planificateur découpé en tranches (ZHL16_PlannerRun, ZHL16_ScenariosRun)
+//
+// Compilation (depuis la racine du dépôt) :
+//   gcc -O2 -std=c99 -IApp/Inc Tools/zhl16_planner_check.c App/Src/zhl16_core.c App/Src/zhl16_kernel.c App/Src/zhl16_fixed.c App/Src/zhl16_tox.c -lm -o zhl16_planner_check
+//
+// Usage : ./zhl16_planner_check [budget_ns]
+// Plongée trimix à 100 m (20 min au fond, 4 gaz), puis plan de remontée calculé
+// par tranches de budget_ns (5 µs par défaut) :
+//   - chaque tranche ne dépasse le budget que d'au plus une étape (pire étape
+//     observée, à CHECK_CLOCK_SLACK_NS près pour les lectures d'horloge) ;
+//   - le plan publié est identique octet pour octet au plan synchrone
+//     (ZHL16_CalculateAscendPlan), de même pour le plan courant et les
+//     scénarios what-if de ZHL16_ScenariosRun ;
+//   - une étape anormalement longue (interruption simulée de CHECK_STALL_NS)
+//     ne bloque pas le calcul, et la pire étape retenue décroît au plan suivant.
+// Code retour 1 au premier écart.
+#define _POSIX_C_SOURCE 199309L
+
+#include "zhl16_core.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CHECK_DEFAULT_BUDGET_NS 5000
+#define CHECK_CLOCK_SLACK_NS    2000        // Lectures d'horloge entre les étapes
+#define CHECK_STALL_NS          5000000     // Interruption simulée pendant une étape
+#define CHECK_MAX_SLICES        10000
+
+static uint32_t check_offset_ns;            // Avance ajoutée à l'horloge (interruptions simulées)
+static uint32_t check_stall_read;           // Lecture à laquelle simuler l'interruption (0 : aucune)
+static uint32_t check_first_read;           // Première et dernière lecture de la tranche en cours
+static uint32_t check_last_read;
+static bool check_slice_started;
+
+static uint32_t Check_Clock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    
+    if (check_stall_read > 0 && --check_stall_read == 0) {
+        check_offset_ns += CHECK_STALL_NS;
+    }
+    
+    uint32_t now = (uint32_t)(ts.tv_sec * 1000000000ull + ts.tv_nsec) + check_offset_ns;
+    if (!check_slice_started) {
+        check_first_read = now;
+        check_slice_started = true;
+    }
+    check_last_read = now;
+    return now;
+}
+
+// Durée de la tranche suivante vue par le planificateur (première à dernière lecture)
+static void Check_SliceBegin(void) {
+    check_slice_started = false;
+}
+
+static uint32_t Check_SliceTime(void) {
+    return check_last_read - check_first_read;
+}
+
+// Descente à 20 m/min sur TX10/70, 20 min au fond à 100 m, une mise à jour par seconde
+static void Check_Dive(ZHL16Model* model) {
+    float depth = 0;
+    
+    ZHL16_Init(model, 1.013, false);
+    ZHL16_AddGas(model, 0, "TX10/70", 0.10, 0.20, 0.70, false);
+    ZHL16_AddGas(model, 1, "TX21/35", 0.21, 0.44, 0.35, false);
+    ZHL16_AddGas(model, 2, "EAN50", 0.50, 0.50, 0.0, false);
+    ZHL16_AddGas(model, 3, "Oxygen", 1.00, 0.00, 0.0, false);
+    
+    for (uint32_t s = 0; depth < 100.0f || s < 20 * 60; s++) {
+        if (depth < 100.0f) {
+            depth += model->config.descent_rate / 60.0f;
+            if (depth > 100.0f) depth = 100.0f;
+            s = 0;
+        }
+        ZHL16_UpdateDepth(model, depth);
+        ZHL16_UpdateTissues(model, 1.0);
+    }
+    ZHL16_GetCeiling(model);
+}
+
+// Tranches d'un plan jusqu'à publication ; faux si une tranche dépasse la borne
+static bool Check_PlannerSlices(ZHL16PlannerJob* job, ZHL16Model* model, uint32_t budget,
+                                uint32_t* slices, uint32_t* max_slice) {
+    bool ok = true;
+    bool done = false;
+    
+    *slices = 0;
+    *max_slice = 0;
+    while (!done && *slices < CHECK_MAX_SLICES) {
+        Check_SliceBegin();
+        done = ZHL16_PlannerRun(job, model, budget, Check_Clock);
+        uint32_t elapsed = Check_SliceTime();
+        (*slices)++;
+        
+        if (elapsed > *max_slice) *max_slice = elapsed;
+        if (elapsed > budget + job->worst_step + CHECK_CLOCK_SLACK_NS) {
+            printf("tranche %u : %u ns pour un budget de %u ns (pire étape %u ns)\n", *slices, elapsed,
+                   budget, job->worst_step);
+            ok = false;
+        }
+    }
+    return ok && done;
+}
+
+static bool Check_SamePlan(const char* name, const AscendPlan* plan, const AscendPlan* reference) {
+    if (memcmp(plan, reference, sizeof(AscendPlan)) == 0) return true;
+    
+    printf("%s : plan différent du plan synchrone (TTS %u, attendu %u ; %u paliers, attendu %u)\n", name,
+           plan->tts, reference->tts, plan->num_stops, reference->num_stops);
+    return false;
+}
+
+int main(int argc, char** argv) {
+    static ZHL16Model dive, reference, sliced, sync;
+    static ZHL16PlannerJob job, sync_job;
+    static ZHL16ScenarioJob batch, sync_batch;
+    uint32_t budget = argc > 1 ? (uint32_t)atoi(argv[1]) : CHECK_DEFAULT_BUDGET_NS;
+    uint32_t slices, max_slice;
+    bool ok = true;
+    
+    Check_Dive(&dive);
+    reference = dive;
+    ZHL16_CalculateAscendPlan(&sync_job, &reference);
+    
+    // Plan seul, par tranches
+    sliced = dive;
+    ZHL16_PlannerBegin(&job, &sliced);
+    ok &= Check_PlannerSlices(&job, &sliced, budget, &slices, &max_slice);
+    ok &= Check_SamePlan("plan", &sliced.ascend_plan, &reference.ascend_plan);
+    printf("planner budget_ns=%u slices=%u max_slice_ns=%u worst_step_ns=%u stops=%u tts=%u\n", budget,
+           slices, max_slice, job.worst_step, sliced.ascend_plan.num_stops, sliced.ascend_plan.tts);
+    
+    // Plan courant et scénarios, par tranches puis d'un coup
+    sliced = dive;
+    ZHL16_ScenariosBegin(&batch, &sliced);
+    slices = 0;
+    max_slice = 0;
+    bool done = false;
+    while (!done && slices < CHECK_MAX_SLICES) {
+        Check_SliceBegin();
+        done = ZHL16_ScenariosRun(&batch, &sliced, budget, Check_Clock);
+        uint32_t elapsed = Check_SliceTime();
+        slices++;
+        if (elapsed > max_slice) max_slice = elapsed;
+        if (elapsed > budget + batch.worst_step + CHECK_CLOCK_SLACK_NS) {
+            printf("scénarios, tranche %u : %u ns (pire étape %u ns)\n", slices, elapsed, batch.worst_step);
+            ok = false;
+        }
+    }
+    ok &= done;
+    
+    sync = dive;
+    ZHL16_ScenariosBegin(&sync_batch, &sync);
+    while (!ZHL16_ScenariosStep(&sync_batch, &sync)) {
+    }
+    ok &= Check_SamePlan("scénarios, plan courant", &sliced.ascend_plan, &reference.ascend_plan);
+    for (int w = 0; w < WHATIF_COUNT; w++) {
+        ok &= Check_SamePlan("scénario what-if", &sliced.what_if[w], &sync.what_if[w]);
+    }
+    printf("scenarios slices=%u max_slice_ns=%u worst_step_ns=%u\n", slices, max_slice, batch.worst_step);
+    
+    // Interruption pendant la première étape : pire étape au-delà du budget,
+    // le calcul avance quand même d'une étape par tranche
+    sliced = dive;
+    ZHL16_PlannerBegin(&job, &sliced);
+    check_stall_read = 3;       // Début de tranche, début d'étape, fin d'étape
+    ok &= Check_PlannerSlices(&job, &sliced, budget, &slices, &max_slice);
+    ok &= Check_SamePlan("plan après interruption", &sliced.ascend_plan, &reference.ascend_plan);
+    uint32_t stalled = job.worst_step;
+    ok &= stalled >= CHECK_STALL_NS;
+    
+    sliced = dive;
+    ZHL16_PlannerBegin(&job, &sliced);
+    ok &= job.worst_step == stalled / 2;
+    printf("stall worst_step_ns=%u slices=%u next_begin_worst_step_ns=%u\n", stalled, slices, job.worst_step);
+    
+    printf("%s\n", ok ? "OK" : "ECHEC");
+    return ok ? 0 : 1;
+}
\ No newline at end of file